@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NANVIX_RUNTIME_INBOX_H_
+#define NANVIX_RUNTIME_INBOX_H_
+
+	#include <posix/sys/types.h>
+
+	/**
+	 * @brief Number of messages that may be parked, per thread.
+	 */
+	#define NANVIX_INBOX_PARKED_MAX 8
+
+	/**
+	 * @brief Tag of untagged messages.
+	 */
+	#define NANVIX_INBOX_UNTAGGED 0
+
+	/**
+	 * @brief Allocates a tag in the standard input mailbox.
+	 *
+	 * @returns Upon successful completion, a nonzero tag is returned.
+	 * Upon failure, a negative error code is returned instead.
+	 *
+	 * @note Tags are private to the calling thread.
+	 */
+	extern int nanvix_inbox_tag(void);
+
+	/**
+	 * @brief Releases a tag of the standard input mailbox.
+	 *
+	 * @param tag Target tag.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 *
+	 * @note Messages with @p tag that are parked are dropped.
+	 */
+	extern int nanvix_inbox_untag(int tag);
+
+	/**
+	 * @brief Reads a message from the standard input mailbox.
+	 *
+	 * @param tag Tag of the message.
+	 * @param buf Target buffer.
+	 * @param n   Number of bytes to read.
+	 *
+	 * @returns Upon successful completion, @p n is returned. Upon
+	 * failure, a negative error code is returned instead. If
+	 * NANVIX_INBOX_PARKED_MAX messages with other tags are parked,
+	 * -ENOBUFS is returned.
+	 *
+	 * @note Messages that do not carry MESSAGE_MAGIC are delivered as
+	 * NANVIX_INBOX_UNTAGGED ones. Responses whose tag is no longer
+	 * allocated are discarded.
+	 */
+	extern ssize_t nanvix_inbox_read(int tag, void *buf, size_t n);
+
+#endif /* NANVIX_RUNTIME_INBOX_H_ */
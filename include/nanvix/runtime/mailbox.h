@@ -26,7 +26,27 @@
 #define NANVIX_RUNTIME_MAILBOX_H_
 
 	#include <nanvix/sys/mailbox.h>
+	#include <nanvix/limits/name.h>
 	#include <posix/sys/types.h>
+	#include <posix/stdint.h>
+
+	/**
+	 * @brief Maximum size of a message packed in a frame.
+	 *
+	 * A packed frame carries the number of messages, and then each
+	 * message prefixed by its size.
+	 */
+	#define NANVIX_MAILBOX_PACKED_MAX \
+		(NANVIX_MAILBOX_MESSAGE_SIZE - 2*sizeof(uint16_t))
+
+	/**
+	 * @brief I/O vector for mailbox messages.
+	 */
+	struct nanvix_mailbox_iovec
+	{
+		const void *iov_base; /**< Message.                    */
+		size_t iov_len;       /**< Size of message (in bytes). */
+	};
 
 	/**
 	 * @brief Get named input mailbox.
@@ -78,6 +98,47 @@
 	 */
 	extern int nanvix_mailbox_write(int mbxid, const void *buf, size_t n);
 
+	/**
+	 * @brief Writes several messages to a mailbox.
+	 *
+	 * @param mbxid  ID of the target mailbox.
+	 * @param iov    Messages.
+	 * @param iovcnt Number of messages.
+	 *
+	 * @returns Upon successful completion, the number of frames written
+	 * is returned. Upon failure, a negative error code is returned
+	 * instead.
+	 *
+	 * @note Consecutive messages are packed in as few frames as fit, and
+	 * frames should be unpacked with nanvix_mailbox_unpack().
+	 */
+	extern int nanvix_mailbox_writev(
+		int mbxid,
+		const struct nanvix_mailbox_iovec *iov,
+		int iovcnt
+	);
+
+	/**
+	 * @brief Unpacks the messages of a frame.
+	 *
+	 * @param frame  Frame written by nanvix_mailbox_writev().
+	 * @param size   Size of @p frame.
+	 * @param iov    Store location for the messages.
+	 * @param iovcnt Length of @p iov.
+	 *
+	 * @returns Upon successful completion, the number of messages in @p
+	 * frame is returned. Upon failure, a negative error code is returned
+	 * instead.
+	 *
+	 * @note Messages are not copied, thus @p iov points to @p frame.
+	 */
+	extern int nanvix_mailbox_unpack(
+		const void *frame,
+		size_t size,
+		struct nanvix_mailbox_iovec *iov,
+		int iovcnt
+	);
+
 	/**
 	 * @brief Closes a mailbox.
 	 *
@@ -32,6 +32,17 @@
 	 */
 	#ifndef __RMEM_CACHE_BLOCK_SIZE
 	#define RMEM_CACHE_BLOCK_SIZE 1
+	#else
+	#define RMEM_CACHE_BLOCK_SIZE __RMEM_CACHE_BLOCK_SIZE
+	#endif
+
+	/**
+	 * @brief Bad size for blocks in the page cache?
+	 */
+	#if ((RMEM_CACHE_BLOCK_SIZE & (RMEM_CACHE_BLOCK_SIZE - 1)) != 0)
+	#error "size of cache blocks should be a power of two"
+	#elif (RMEM_CACHE_BLOCK_SIZE > RMEM_RUN_MAX)
+	#error "size of cache blocks should not exceed RMEM_RUN_MAX"
 	#endif
 
 	/**
@@ -67,6 +78,14 @@
 
 #if defined(__NEED_RMEM_CACHE)
 
+	/**
+	 * @brief Handler of page evictions.
+	 *
+	 * @param pgnum Number of the evicted page.
+	 * @param page  Local page that held the evicted page.
+	 */
+	typedef void (*rcache_evict_fn)(rpage_t pgnum, void *page);
+
 	/**
 	 * @brief Allocates a remote page.
 	 *
@@ -76,6 +95,17 @@
 	 */
 	extern rpage_t nanvix_rcache_alloc(void);
 
+	/**
+	 * @brief Allocates a cache line of remote pages.
+	 *
+	 * @returns Upon successful completion, the number of the first
+	 * page of a newly allocated run of @p RMEM_CACHE_BLOCK_SIZE
+	 * remote pages is returned. The run lies in a single server and
+	 * it is aligned to a cache line boundary. Upon failure, @p
+	 * RMEM_NULL is returned instead.
+	 */
+	extern rpage_t nanvix_rcache_alloc_line(void);
+
 	/**
 	 * @brief Cleans the cache..
 	 */
@@ -102,6 +132,162 @@
 	 */
 	extern void *nanvix_rcache_get(rpage_t pgnum);
 
+	/**
+	 * @brief Gets remote page for a full overwrite.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, a pointer to a local
+	 * mapping of the remote page is returned. Upon failure, a @p
+	 * NULL pointer is returned instead.
+	 *
+	 * @note Contents of the page are undefined on a miss.
+	 */
+	extern void *nanvix_rcache_install(rpage_t pgnum);
+
+	/**
+	 * @brief Reads remote pages around the page cache.
+	 *
+	 * @param pgnum  Number of the first target page.
+	 * @param buf    Target buffer.
+	 * @param npages Number of consecutive pages (up to @p RMEM_RUN_MAX).
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 *
+	 * @note Unlike nanvix_rcache_read(), this works in any mode.
+	 */
+	extern int nanvix_rcache_stream_read(rpage_t pgnum, void *buf, int npages);
+
+	/**
+	 * @brief Writes remote pages around the page cache.
+	 *
+	 * @param pgnum  Number of the first target page.
+	 * @param buf    Source buffer.
+	 * @param npages Number of consecutive pages (up to @p RMEM_RUN_MAX).
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 *
+	 * @note Unlike nanvix_rcache_write(), this works in any mode.
+	 */
+	extern int nanvix_rcache_stream_write(rpage_t pgnum, const void *buf, int npages);
+
+	/**
+	 * @brief Loads a remote page into the page cache.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead. If the
+	 * cache is in bypass mode, -ENOTSUP is returned.
+	 */
+	extern int nanvix_rcache_prefetch(rpage_t pgnum);
+
+	/**
+	 * @brief Loads several remote pages into the page cache.
+	 *
+	 * @param pgnums Numbers of the target pages.
+	 * @param n      Number of pages in @p pgnums.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead. If the
+	 * cache is in bypass mode, -ENOTSUP is returned.
+	 *
+	 * @note Requests to different servers are overlapped.
+	 */
+	extern int nanvix_rcache_fetchv(const rpage_t *pgnums, int n);
+
+	/**
+	 * @brief Claims a cache line for a remote page.
+	 *
+	 * @param pgnum Number of the target page.
+	 * @param line  Store location for the claimed line.
+	 *
+	 * @returns If the page is cached, zero is returned. If a line is
+	 * claimed, one is returned and @p line is set. If the page is
+	 * being filled, -EAGAIN is returned. Upon failure a negative
+	 * error code is returned instead.
+	 */
+	extern int nanvix_rcache_claim(rpage_t pgnum, int *line);
+
+	/**
+	 * @brief Fills claimed cache lines.
+	 *
+	 * @param lines Target lines.
+	 * @param n     Number of lines in @p lines.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 *
+	 * @note The metadata of the page cache is not changed, thus
+	 * locks that protect it need not be held.
+	 */
+	extern int nanvix_rcache_fillv(const int *lines, int n);
+
+	/**
+	 * @brief Releases a claimed cache line.
+	 *
+	 * @param line Target line.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_release(int line);
+
+	/**
+	 * @brief Writes back and evicts a remote page from the page cache.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_evict(rpage_t pgnum);
+
+	/**
+	 * @brief Reads remote pages without caching them.
+	 *
+	 * @param pgnum  Number of the first target page.
+	 * @param buf    Target buffer.
+	 * @param npages Number of consecutive pages (up to @p RMEM_RUN_MAX).
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead. If the
+	 * cache is not in bypass mode, -ENOTSUP is returned.
+	 */
+	extern int nanvix_rcache_read(rpage_t pgnum, void *buf, int npages);
+
+	/**
+	 * @brief Writes remote pages without caching them.
+	 *
+	 * @param pgnum  Number of the first target page.
+	 * @param buf    Source buffer.
+	 * @param npages Number of consecutive pages (up to @p RMEM_RUN_MAX).
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead. If the
+	 * cache is not in bypass mode, -ENOTSUP is returned.
+	 */
+	extern int nanvix_rcache_write(rpage_t pgnum, const void *buf, int npages);
+
+	/**
+	 * @brief Peeks at a cached remote page.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns If the page is cached, a pointer to its local copy is
+	 * returned. Otherwise, a @p NULL pointer is returned instead.
+	 */
+	extern void *nanvix_rcache_peek(rpage_t pgnum);
+
+	/**
+	 * @brief Registers a handler of page evictions.
+	 *
+	 * @param fn Target handler (@p NULL to unregister).
+	 */
+	extern void nanvix_rcache_evict_handler(rcache_evict_fn fn);
+
 	/**
 	 * @brief Puts remote page.
 	 *
@@ -122,6 +308,28 @@
 	 */
 	extern int nanvix_rcache_flush(rpage_t pgnum);
 
+	/**
+	 * @brief Pins a remote page in the page cache.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 *
+	 * @note A pinned page is never selected for eviction.
+	 */
+	extern int nanvix_rcache_pin(rpage_t pgnum);
+
+	/**
+	 * @brief Unpins a remote page in the page cache.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_unpin(rpage_t pgnum);
+
 	/**
 	 * @brief Initializes the page cache.
 	 *
@@ -30,6 +30,46 @@
 
 #if defined(__NEED_MM_MANAGER)
 
+	/**
+	 * @name Access patterns for remote memory.
+	 */
+	/**@{*/
+	#define RMEM_ADVICE_NORMAL     0 /**< No particular pattern.    */
+	#define RMEM_ADVICE_SEQUENTIAL 1 /**< Sequential accesses.      */
+	#define RMEM_ADVICE_RANDOM     2 /**< Random accesses.          */
+	#define RMEM_ADVICE_WILLNEED   3 /**< Accessed in near future.  */
+	#define RMEM_ADVICE_DONTNEED   4 /**< Not accessed anymore.     */
+	#define RMEM_ADVICE_NOREUSE    5 /**< Accessed once.            */
+	/**@}*/
+
+	/**
+	 * @brief I/O vector for remote memory transfers.
+	 */
+	struct rmem_iovec
+	{
+		void *iov_base; /**< Local buffer.                */
+		size_t iov_len; /**< Length of buffer (in bytes). */
+	};
+
+	/**
+	 * @brief Number of pages mapped on a fault in sequential regions.
+	 */
+	#ifndef __RMEM_FAULT_READAHEAD
+	#define RMEM_FAULT_READAHEAD 8
+	#else
+	#define RMEM_FAULT_READAHEAD __RMEM_FAULT_READAHEAD
+	#endif
+
+	/**
+	 * @brief Remote page fault being handled.
+	 */
+	struct rfault
+	{
+		vaddr_t vaddr;                   /**< Faulting page.           */
+		int nlines;                      /**< Number of claimed lines. */
+		int lines[RMEM_FAULT_READAHEAD]; /**< Claimed cache lines.     */
+	};
+
 	/**
 	 * @brief Handles a remote page fault.
 	 *
@@ -40,6 +80,38 @@
 	 */
 	extern int nanvix_rfault(vaddr_t vaddr);
 
+	/**
+	 * @brief Starts handling a remote page fault.
+	 *
+	 * @param vaddr Faulting virtual address.
+	 * @param fault Store location for the fault.
+	 *
+	 * @returns Upon successful completion, zero is returned. If the
+	 * faulting page is being fetched by another fault, -EAGAIN is
+	 * returned. Upon failure, a negative error code is returned
+	 * instead.
+	 */
+	extern int nanvix_rfault_claim(vaddr_t vaddr, struct rfault *fault);
+
+	/**
+	 * @brief Fetches the pages of a remote page fault.
+	 *
+	 * @param fault Target fault.
+	 *
+	 * @note The page cache and the page maps are not changed.
+	 */
+	extern void nanvix_rfault_fetch(struct rfault *fault);
+
+	/**
+	 * @brief Completes a remote page fault.
+	 *
+	 * @param fault Target fault.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rfault_link(struct rfault *fault);
+
 	/**
 	 * @brief Allocates remote memory.
 	 *
@@ -51,6 +123,20 @@
 	 */
 	extern void *nanvix_vmem_alloc(size_t n);
 
+	/**
+	 * @brief Reserves remote memory.
+	 *
+	 * @param n Number of pages to reserve.
+	 *
+	 * @returns Upon successful completion, a pointer to the newly
+	 * reserved remote memory area is returned. Upon failure, a null
+	 * pointer is returned instead.
+	 *
+	 * @note Remote memory is allocated on first touch, and pages that
+	 * were never touched read as zeros.
+	 */
+	extern void *nanvix_vmem_reserve(size_t n);
+
 	/**
 	 * @brief Frees remote memory.
 	 *
@@ -69,6 +155,8 @@
 	 * @param n   Number of bytes to read.
 	 *
 	 * @returns The number of bytes read from remote memory.
+	 *
+	 * @note The target area may span several pages.
 	 */
 	extern size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n);
 
@@ -80,9 +168,72 @@
 	 * @param n   Number of bytes to write.
 	 *
 	 * @returns The number of bytes written to remote memory.
+	 *
+	 * @note The target area may span several pages.
 	 */
 	extern size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n);
 
+	/**
+	 * @brief Advises on the access pattern of remote memory.
+	 *
+	 * @param ptr    Target remote memory area (page aligned).
+	 * @param len    Length of target area (in bytes).
+	 * @param advice Access pattern (RMEM_ADVICE_*).
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_vmem_advise(void *ptr, size_t len, int advice);
+
+	/**
+	 * @brief Moves remote memory without copying it.
+	 *
+	 * @param dst Target remote memory area (page aligned).
+	 * @param src Source remote memory area (page aligned).
+	 * @param n   Number of bytes to move.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 *
+	 * @note Pages at @p src read as zeros afterwards.
+	 */
+	extern int nanvix_vmem_remap(void *dst, const void *src, size_t n);
+
+	/**
+	 * @brief Fills remote memory with zeros.
+	 *
+	 * @param ptr Target remote memory area.
+	 * @param n   Number of bytes to fill.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 *
+	 * @note Pages that were never touched are not written.
+	 */
+	extern int nanvix_vmem_zero(void *ptr, size_t n);
+
+	/**
+	 * @brief Reads data from remote memory into several buffers.
+	 *
+	 * @param ptr    Target remote memory area.
+	 * @param iov    Local buffers where data should be placed.
+	 * @param iovcnt Number of local buffers.
+	 *
+	 * @returns The number of bytes read from remote memory.
+	 */
+	extern size_t nanvix_vmem_readv(const void *ptr, const struct rmem_iovec *iov, int iovcnt);
+
+	/**
+	 * @brief Writes data from several buffers to remote memory.
+	 *
+	 * @param ptr    Target remote memory area.
+	 * @param iov    Local buffers from where data should be retrieved.
+	 * @param iovcnt Number of local buffers.
+	 *
+	 * @returns The number of bytes written to remote memory.
+	 */
+	extern size_t nanvix_vmem_writev(void *ptr, const struct rmem_iovec *iov, int iovcnt);
+
 #endif /* __NEED_MM_MANAGER */
 
 #endif /* NANVIX_RUNTIME_MM_MANAGER_H_ */
@@ -29,6 +29,18 @@
 
 #if defined(__NEED_MM_STUB)
 
+	/**
+	 * @brief Request to the remote memory.
+	 */
+	struct rmem_request
+	{
+		int tag;      /**< Tag of the request.   */
+		int serverid; /**< Target server.        */
+		void *buf;    /**< Target buffer.        */
+		int nblocks;  /**< Number of blocks.     */
+		size_t ret;   /**< Number of bytes read. */
+	};
+
 	/**
 	 * @brief Allocates a remote memory block.
 	 *
@@ -38,6 +50,18 @@
 	 */
 	extern rpage_t nanvix_rmem_alloc(void);
 
+	/**
+	 * @brief Allocates a run of remote memory blocks.
+	 *
+	 * @param nblocks Number of blocks to allocate.
+	 *
+	 * @returns Upon successful completion, the number of the first
+	 * block of the newly allocated run is returned. The run lies in a
+	 * single server and it is aligned to @p nblocks. Upon failure,
+	 * @p RMEM_NULL is returned instead.
+	 */
+	extern rpage_t nanvix_rmem_nalloc(int nblocks);
+
 	/**
 	 * @brief Frees a remote memory block.
 	 *
@@ -59,6 +83,47 @@
 	 */
 	extern size_t nanvix_rmem_read(rpage_t blknum, void *buf);
 
+	/**
+	 * @brief Reads a run of blocks from the remote memory.
+	 *
+	 * @param blknum  Number of the first block in the run.
+	 * @param buf     Location where the data should be written to.
+	 * @param nblocks Number of blocks to read.
+	 *
+	 * @returns Upon successful completion, the number of bytes read is
+	 * returned. Upon failure, zero is returned instead.
+	 *
+	 * @note Blocks in the run that are not owned by the caller are
+	 * holes and they are read as zeros.
+	 */
+	extern size_t nanvix_rmem_nread(rpage_t blknum, void *buf, int nblocks);
+
+	/**
+	 * @brief Starts reading a run of blocks from the remote memory.
+	 *
+	 * @param req     Storage for the request.
+	 * @param blknum  Number of the first block in the run.
+	 * @param buf     Location where the data should be written to.
+	 * @param nblocks Number of blocks to read.
+	 *
+	 * @returns Upon successful completion, zero is returned and the
+	 * request should be completed with nanvix_rmem_wait(). Upon
+	 * failure, a negative error code is returned instead.
+	 *
+	 * @note Only one request to each server should be outstanding.
+	 */
+	extern int nanvix_rmem_nread_async(struct rmem_request *req, rpage_t blknum, void *buf, int nblocks);
+
+	/**
+	 * @brief Completes a request to the remote memory.
+	 *
+	 * @param req Target request.
+	 *
+	 * @returns Upon successful completion, the number of bytes read is
+	 * returned. Upon failure, zero is returned instead.
+	 */
+	extern size_t nanvix_rmem_wait(struct rmem_request *req);
+
 	/**
 	 * @brief Writes data to the remote memory.
 	 *
@@ -70,6 +135,21 @@
 	 */
 	extern size_t nanvix_rmem_write(rpage_t blknum, const void *buf);
 
+	/**
+	 * @brief Writes a run of blocks to the remote memory.
+	 *
+	 * @param blknum  Number of the first block in the run.
+	 * @param buf     Location where the data should be read from.
+	 * @param nblocks Number of blocks to write.
+	 *
+	 * @returns Upon successful completion, the number of bytes
+	 * written is returned. Upon failure, zero is returned instead.
+	 *
+	 * @note Writes to blocks in the run that are not owned by the
+	 * caller are dropped.
+	 */
+	extern size_t nanvix_rmem_nwrite(rpage_t blknum, const void *buf, int nblocks);
+
 	/**
 	 * @brief Shutdowns aall remote memory servers.
 	 *
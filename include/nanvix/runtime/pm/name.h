@@ -25,12 +25,73 @@
 #ifndef NANVIX_RUNTIME_PM_NAME_H_
 #define NANVIX_RUNTIME_PM_NAME_H_
 
+	/**
+	 * @brief Operation types for Name Server.
+	 */
+	/**@{*/
+	#define NAME_EXIT        0 /**< Exit request.            */
+	#define NAME_LOOKUP      1 /**< lookup a name.           */
+	#define NAME_LINK        2 /**< Add a new name.          */
+	#define NAME_UNLINK      3 /**< Remove a name.           */
+	#define NAME_SUCCESS     4 /**< Success acknowledgement. */
+	#define NAME_ALIVE       5 /**< Client alive.            */
+	#define NAME_FAIL        6 /**< Failure acknowledgement. */
+	#define NAME_LOOKUP_MANY 7 /**< Lookup several names.    */
+	#define NAME_LINK_MANY   8 /**< Add several names.       */
+	#define NAME_WAIT        9 /**< Wait for a name.         */
+	#define NAME_STATS      10 /**< Get statistics.          */
+	#define NAME_LIST       11 /**< Enumerate names.         */
+	/**@}*/
+
+	/**
+	 * @brief Number of operation types for Name Server.
+	 */
+	#define NAME_OPCODES_NUM 12
+
 #ifdef __NAME_SERVICE
 
 	#include <nanvix/servers/name.h>
 
 #endif /* __NAME_SERVICE */
 
+	#include <posix/stdint.h>
+
+	/**
+	 * @brief Age of a name whose NoC node never sent a heartbeat.
+	 */
+	#define NAME_AGE_UNKNOWN ((uint64_t) -1)
+
+	/**
+	 * @brief Service time of a Name Service operation.
+	 */
+	struct name_latency
+	{
+		int count;       /**< Number of requests.   */
+		uint64_t cycles; /**< Total service time.   */
+		uint64_t max;    /**< Longest service time. */
+	};
+
+	/**
+	 * @brief Statistics of the Name Service.
+	 */
+	struct name_stats
+	{
+		int nnames;     /**< Registered names.     */
+		int nlinks;     /**< Names linked.         */
+		int nunlinks;   /**< Names unlinked.       */
+		int nlookups;   /**< Names looked up.      */
+		int nevictions; /**< NoC nodes found dead. */
+
+		/**
+		 * @brief Service times, indexed by operation.
+		 *
+		 * Only lookups, links, unlinks, heartbeats, batched lookups,
+		 * batched links and waits are timed. Entries of other
+		 * operations are zero.
+		 */
+		struct name_latency latency[NAME_OPCODES_NUM];
+	};
+
 	/**
 	 * @brief Initializes the Name Service client.
 	 *
@@ -58,6 +119,20 @@
 	 */
 	extern int name_link(int nodenum, const char *name);
 
+	/**
+	 * @brief Links several process names.
+	 *
+	 * @param nodenum NoC node ID of the process to link.
+	 * @param names   Names of the process to link.
+	 * @param results Store location for per-name results (zero or a
+	 *                negative error code).
+	 * @param n       Number of names.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int name_link_many(int nodenum, const char **names, int *results, int n);
+
 	/**
 	 * @brief Converts a name into a NoC node ID.
 	 *
@@ -69,6 +144,74 @@
 	 */
 	extern int name_lookup(const char *name);
 
+	/**
+	 * @brief Converts several names into NoC node IDs.
+	 *
+	 * @param names    Target names.
+	 * @param nodenums Store location for NoC node IDs (or negative
+	 *                 error codes, for names that cannot be converted).
+	 * @param n        Number of names.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int name_lookup_many(const char **names, int *nodenums, int n);
+
+	/**
+	 * @brief Converts a name into a NoC node ID and reports its age.
+	 *
+	 * @param name Target name.
+	 * @param age  Store location for the number of cycles since the
+	 *             last heartbeat of the NoC node (NAME_AGE_UNKNOWN if
+	 *             it never sent one).
+	 *
+	 * @returns Upon successful completion the NoC node ID whose name is @p
+	 * name is returned. Upon failure, a negative error code is returned
+	 * instead.
+	 */
+	extern int name_lookup_age(const char *name, uint64_t *age);
+
+	/**
+	 * @brief Gets statistics of the Name Service.
+	 *
+	 * @param buf Store location for statistics.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int name_stats(struct name_stats *buf);
+
+	/**
+	 * @brief Enumerates registered names.
+	 *
+	 * @param cursor  Zero for the first name, or the value returned by
+	 *                the previous call.
+	 * @param name    Store location for the name.
+	 * @param nodenum Store location for the NoC node ID of the name.
+	 * @param age     Store location for the number of cycles since the
+	 *                last heartbeat of the NoC node (NAME_AGE_UNKNOWN if
+	 *                it never sent one).
+	 *
+	 * @returns Upon successful completion, a positive cursor for the
+	 * next name is returned. If there are no more names, -ENOENT is
+	 * returned. Upon failure, a negative error code is returned instead.
+	 */
+	extern int name_list(int cursor, char *name, int *nodenum, uint64_t *age);
+
+	/**
+	 * @brief Waits for a name to be linked.
+	 *
+	 * @param name Target name.
+	 *
+	 * @returns Upon successful completion the NoC node ID whose name is @p
+	 * name is returned. Upon failure, a negative error code is returned
+	 * instead.
+	 *
+	 * @note -ETIMEDOUT is returned if @p name is not linked within
+	 * NAME_WAIT_TIMEOUT.
+	 */
+	extern int name_wait(const char *name);
+
 	/**
 	 * @brief Unlink a process name.
 	 *
@@ -79,6 +222,13 @@
 	 */
 	extern int name_unlink(const char *name);
 
+	/**
+	 * @brief Drops a name from the name cache.
+	 *
+	 * @param name Target name (NULL drops all names).
+	 */
+	extern void name_cache_invalidate(const char *name);
+
 	/**
 	 * @brief Updates the timestamp of a process.
 	 *
@@ -87,6 +237,17 @@
 	 */
 	extern int name_heartbeat(void);
 
+	/**
+	 * @brief Stops tracking the liveness of a process.
+	 *
+	 * @returns Upons successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 *
+	 * @note Names of the calling process are no longer unlinked when
+	 * it stays silent. The next heartbeat tracks it again.
+	 */
+	extern int name_heartbeat_stop(void);
+
 	/**
 	 * @brief Shutdowns the name server.
 	 *
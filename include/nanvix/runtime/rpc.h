@@ -0,0 +1,265 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NANVIX_RUNTIME_RPC_H_
+#define NANVIX_RUNTIME_RPC_H_
+
+	#include <nanvix/servers/message.h>
+	#include <nanvix/sys/semaphore.h>
+	#include <nanvix/sys/thread.h>
+	#include <nanvix/limits/name.h>
+	#include <posix/sys/types.h>
+	#include <posix/stdint.h>
+
+	/**
+	 * @brief Maximum number of operations of a server.
+	 */
+	#define NANVIX_RPC_OPCODES_MAX 16
+
+	/**
+	 * @brief Number of cached reply channels of a server.
+	 */
+	#define NANVIX_RPC_CHANNELS_MAX 8
+
+	/**
+	 * @brief Maximum number of dispatch threads of a server.
+	 */
+	#define NANVIX_RPC_THREADS_MAX (THREAD_MAX - 1)
+
+	/**
+	 * @name Return values of request handlers.
+	 */
+	/**@{*/
+	#define NANVIX_RPC_REPLY    0 /**< Send the response.        */
+	#define NANVIX_RPC_NOREPLY  1 /**< Do not send any response. */
+	#define NANVIX_RPC_SHUTDOWN 2 /**< Stop the server.          */
+	/**@}*/
+
+	/**
+	 * @name Server flags.
+	 */
+	/**@{*/
+	#define NANVIX_RPC_CONCURRENT (1 << 0) /**< Handlers are thread-safe. */
+	/**@}*/
+
+	/* Forward definitions. */
+	struct nanvix_rpc_server;
+
+	/**
+	 * @brief Request handler.
+	 *
+	 * @param server   Target server.
+	 * @param request  Request.
+	 * @param response Response, initialized as a copy of @p request.
+	 *
+	 * @returns One of NANVIX_RPC_REPLY, NANVIX_RPC_NOREPLY or
+	 * NANVIX_RPC_SHUTDOWN.
+	 */
+	typedef int (*nanvix_rpc_handler_t)(
+		struct nanvix_rpc_server *server,
+		const void *request,
+		void *response
+	);
+
+	/**
+	 * @brief Service time of an operation.
+	 */
+	struct nanvix_rpc_stats
+	{
+		int count;       /**< Number of requests.   */
+		uint64_t cycles; /**< Total service time.   */
+		uint64_t max;    /**< Longest service time. */
+	};
+
+	/**
+	 * @brief RPC server.
+	 */
+	struct nanvix_rpc_server
+	{
+		int inbox;    /**< Input mailbox.           */
+		int port;     /**< Port of input mailbox.   */
+		size_t size;  /**< Size of messages.        */
+		int flags;    /**< Server flags.            */
+		int nthreads; /**< Dispatch threads.        */
+		int shutdown; /**< Stop dispatching?        */
+		int nblocked; /**< Threads reading inbox.   */
+
+		/**
+		 * @brief Request handlers, per operation.
+		 */
+		nanvix_rpc_handler_t handlers[NANVIX_RPC_OPCODES_MAX];
+
+		/**
+		 * @brief Service times, per operation.
+		 */
+		struct nanvix_rpc_stats stats[NANVIX_RPC_OPCODES_MAX];
+
+		/**
+		 * @brief Cached reply channels.
+		 */
+		struct
+		{
+			int nodenum;  /**< Remote NoC node (-1 if free). */
+			int port;     /**< Remote port.                  */
+			int outbox;   /**< Output mailbox.               */
+			unsigned age; /**< Time of last use.             */
+		} channels[NANVIX_RPC_CHANNELS_MAX];
+
+		unsigned clock;                        /**< Clock for reply channels.    */
+		struct nanvix_semaphore lock;          /**< Lock for handlers.           */
+		struct nanvix_semaphore channels_lock; /**< Lock for reply channels.     */
+		struct nanvix_semaphore state_lock;    /**< Lock for shutdown and stats. */
+	};
+
+	/**
+	 * @brief Initializes an RPC server.
+	 *
+	 * @param server Target server.
+	 * @param inbox  Input mailbox.
+	 * @param port   Port number of @p inbox.
+	 * @param size   Size of messages.
+	 * @param flags  Server flags.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_server_init(
+		struct nanvix_rpc_server *server,
+		int inbox,
+		int port,
+		size_t size,
+		int flags
+	);
+
+	/**
+	 * @brief Releases resources of an RPC server.
+	 *
+	 * @param server Target server.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_server_cleanup(struct nanvix_rpc_server *server);
+
+	/**
+	 * @brief Registers a request handler.
+	 *
+	 * @param server  Target server.
+	 * @param opcode  Target operation.
+	 * @param handler Request handler.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_register(
+		struct nanvix_rpc_server *server,
+		int opcode,
+		nanvix_rpc_handler_t handler
+	);
+
+	/**
+	 * @brief Dispatches requests until the server is shut down.
+	 *
+	 * @param server   Target server.
+	 * @param nthreads Number of dispatch threads, including the caller.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_loop(struct nanvix_rpc_server *server, int nthreads);
+
+	/**
+	 * @brief Gets a reply channel.
+	 *
+	 * @param server  Target server.
+	 * @param nodenum Remote NoC node.
+	 * @param port    Remote port.
+	 *
+	 * @returns Upon successful completion, the ID of an output mailbox to
+	 * the remote port is returned. Upon failure, a negative error code is
+	 * returned instead.
+	 */
+	extern int nanvix_rpc_channel(
+		struct nanvix_rpc_server *server,
+		int nodenum,
+		int port
+	);
+
+	/**
+	 * @brief Sends a response out of band.
+	 *
+	 * @param server   Target server.
+	 * @param nodenum  Remote NoC node.
+	 * @param port     Remote port.
+	 * @param response Response.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 *
+	 * @note Callers are in charge of setting the tag of @p response.
+	 */
+	extern int nanvix_rpc_reply(
+		struct nanvix_rpc_server *server,
+		int nodenum,
+		int port,
+		const void *response
+	);
+
+	/**
+	 * @brief Sends a request of a remote procedure call.
+	 *
+	 * @param outbox Output mailbox to the server.
+	 * @param msg    Request.
+	 * @param size   Size of messages.
+	 *
+	 * @returns Upon successful completion, the tag of the request is
+	 * returned. Upon failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_send(int outbox, void *msg, size_t size);
+
+	/**
+	 * @brief Receives the response of a remote procedure call.
+	 *
+	 * @param tag  Tag of the request.
+	 * @param msg  Target buffer for the response.
+	 * @param size Size of messages.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_recv(int tag, void *msg, size_t size);
+
+	/**
+	 * @brief Issues a remote procedure call.
+	 *
+	 * @param outbox Output mailbox to the server.
+	 * @param msg    Request, overwritten with the response.
+	 * @param size   Size of messages.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rpc_call(int outbox, void *msg, size_t size);
+
+#endif /* NANVIX_RUNTIME_RPC_H_ */
@@ -27,6 +27,15 @@
 
     #include <posix/stdint.h>
 
+	/**
+	 * @brief Mark of messages that are built by the runtime.
+	 *
+	 * Application messages share the standard input mailbox with
+	 * responses of system services, so the tag of a message is looked
+	 * at only if it carries this mark.
+	 */
+	#define MESSAGE_MAGIC 0x4e56
+
 	/**
 	 * @brief Polymorphic message header.
 	 */
@@ -36,6 +45,8 @@
 		uint8_t opcode;       /**< Operation.      */
 		uint8_t mailbox_port; /**< Port Number     */
 		uint8_t portal_port;  /**< Port Number     */
+		uint8_t tag;          /**< Request tag.    */
+		uint16_t magic;       /**< MESSAGE_MAGIC.  */
 	} message_header;
 
 	/**
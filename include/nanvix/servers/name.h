@@ -30,6 +30,7 @@
 	#endif
 
 	#include <nanvix/servers/message.h>
+	#include <nanvix/servers/spawn.h>
 	#include <nanvix/limits/name.h>
 	#include <nanvix/pm.h>
 	#include <nanvix/ulib.h>
@@ -37,23 +38,89 @@
 	#include <posix/errno.h>
 
 	/**
-	 * @brief Operation types for Name Server.
+	 * @brief Number of operations whose service times are reported.
 	 */
-	/**@{*/
-	#define NAME_EXIT    0 /**< Exit request.            */
-	#define NAME_LOOKUP  1 /**< lookup a name.           */
-	#define NAME_LINK    2 /**< Add a new name.          */
-	#define NAME_UNLINK  3 /**< Remove a name.           */
-	#define NAME_SUCCESS 4 /**< Success acknowledgement. */
-	#define NAME_ALIVE   5 /**< Client alive.            */
-	#define NAME_FAIL    6 /**< Failure acknowledgement. */
-	/**@}*/
+	#define NAME_TIMED_NUM 7
+
+	/**
+	 * @brief Asserts whether service times of an operation are reported.
+	 *
+	 * @param opcode Target operation.
+	 *
+	 * @returns Non-zero if a NAME_STATS reply carries service times of
+	 * @p opcode, and zero otherwise.
+	 *
+	 * @note Replies carry them in opcode order. Acknowledgements,
+	 * shutdowns and introspection requests are left out, so that service
+	 * times of the others fit in a single message.
+	 */
+	static inline int name_opcode_is_timed(int opcode)
+	{
+		return (
+			(opcode == NAME_LOOKUP)      ||
+			(opcode == NAME_LINK)        ||
+			(opcode == NAME_UNLINK)      ||
+			(opcode == NAME_ALIVE)       ||
+			(opcode == NAME_LOOKUP_MANY) ||
+			(opcode == NAME_LINK_MANY)   ||
+			(opcode == NAME_WAIT)
+		);
+	}
+
+	/**
+	 * @brief Maximum number of names in a batched request.
+	 */
+	#define NAME_BATCH_MAX 8
+
+	/**
+	 * @brief Size of the packed names in a batched request.
+	 *
+	 * Packed names take up whatever is left of a mailbox message,
+	 * past the header and the name count.
+	 */
+	#define NAME_BATCH_SIZE \
+		(NANVIX_MAILBOX_MESSAGE_SIZE - sizeof(message_header) - sizeof(int))
+
+	/**
+	 * @brief Liveness timeout (in cycles).
+	 *
+	 * Names of a NoC node that has sent heartbeats, but then stays
+	 * silent for longer than this, are unlinked, even if the node shows
+	 * up again later. Nodes that stop sending heartbeats should opt out
+	 * first. Zero disables eviction.
+	 */
+	#ifndef __NAME_ALIVE_TIMEOUT
+	#define NAME_ALIVE_TIMEOUT (16*CLUSTER_FREQ)
+	#else
+	#define NAME_ALIVE_TIMEOUT __NAME_ALIVE_TIMEOUT
+	#endif
+
+	/**
+	 * @brief Wait timeout (in cycles).
+	 *
+	 * Waits for names that are not linked within this are failed with
+	 * -ETIMEDOUT. Zero disables expiration.
+	 */
+	#ifndef __NAME_WAIT_TIMEOUT
+	#define NAME_WAIT_TIMEOUT (32*CLUSTER_FREQ)
+	#else
+	#define NAME_WAIT_TIMEOUT __NAME_WAIT_TIMEOUT
+	#endif
 
 	/**
 	 * @brief Port number for name server client.
 	 */
 	#define NAME_SERVER_PORT_NUM 2
 
+	/**
+	 * @brief Table of Name Servers.
+	 */
+	extern struct name_servers_info
+	{
+		int nodenum;
+		int portnum;
+	} name_servers[NAME_SERVERS_NUM];
+
 	/**
 	 * @brief Name Server message.
 	 */
@@ -84,7 +151,8 @@
 
 			struct
 			{
-				uint64_t timestamp; /**< Time stamp. */
+				uint64_t timestamp; /**< Time stamp.          */
+				int track;          /**< Keep track of node? */
 
 			} heartbeat;
 
@@ -95,9 +163,63 @@
 
 			struct
 			{
-				int nodenum; /**< NoC node.   */
-				int errcode; /**< Error code. */
+				int cursor; /**< First entry to look at. */
+			} list;
+
+			struct
+			{
+				int count;                   /**< Number of names.          */
+				char names[NAME_BATCH_SIZE]; /**< Null-separated names.     */
+			} many;
+
+			struct
+			{
+				int nodenum;  /**< NoC node.                    */
+				int errcode;  /**< Error code.                  */
+				uint64_t age; /**< Cycles since last heartbeat. */
 			} ret;
+
+			/* Leading fields match those of ret. */
+			struct
+			{
+				int count;                      /**< Number of names.   */
+				int errcode;                    /**< Error code.        */
+				int16_t values[NAME_BATCH_MAX]; /**< Per-name results.  */
+			} ret_many;
+
+			/* Second field matches that of ret. */
+			struct
+			{
+				int nnames;     /**< Registered names.      */
+				int errcode;    /**< Error code.            */
+				int nlinks;     /**< Names linked.          */
+				int nunlinks;   /**< Names unlinked.        */
+				int nlookups;   /**< Names looked up.       */
+				int nevictions; /**< NoC nodes found dead.  */
+
+				/**
+				 * @brief Service times of timed operations.
+				 *
+				 * Narrowed to 32 bits, so that they fit in a
+				 * single message. Values that do not fit saturate.
+				 */
+				struct
+				{
+					uint32_t count; /**< Number of requests.   */
+					uint32_t mean;  /**< Mean service time.    */
+					uint32_t max;   /**< Longest service time. */
+				} latency[NAME_TIMED_NUM];
+			} ret_stats;
+
+			/* Leading fields match those of ret. */
+			struct
+			{
+				int nodenum;                     /**< NoC node.                    */
+				int errcode;                     /**< Error code.                  */
+				int next;                        /**< Cursor of next entry.        */
+				uint64_t age;                    /**< Cycles since last heartbeat. */
+				char name[NANVIX_PROC_NAME_MAX]; /**< Name.                        */
+			} ret_list;
 		} op;
 	};
 
@@ -126,4 +248,35 @@
 		return (0);
 	}
 
+	/**
+	 * @brief Hashes a name.
+	 *
+	 * @param name Target name.
+	 *
+	 * @returns The hash of @p name.
+	 */
+	static inline uint32_t name_hash(const char *name)
+	{
+		uint32_t hash = 5381;
+
+		while (*name != '\0')
+			hash = ((hash << 5) + hash) + (unsigned char) *name++;
+
+		return (hash);
+	}
+
+	/**
+	 * @brief Gets the Name Server that is in charge of a name.
+	 *
+	 * @param name Target name.
+	 *
+	 * @returns The index of the Name Server that keeps @p name.
+	 *
+	 * @note Names are partitioned among Name Servers by hash.
+	 */
+	static inline int name_server_of(const char *name)
+	{
+		return (name_hash(name) % NAME_SERVERS_NUM);
+	}
+
 #endif /* NANVIX_SERVERS_NAME_H_ */
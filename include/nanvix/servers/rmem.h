@@ -61,6 +61,15 @@
 	 */
 	#define RMEM_NUM_BLOCKS (RMEM_SIZE/RMEM_BLOCK_SIZE)
 
+	/**
+	 * @brief Maximum number of blocks in a run.
+	 *
+	 * A run is a sequence of consecutive blocks that lie in the same
+	 * server and that are allocated, read and written with a single
+	 * request.
+	 */
+	#define RMEM_RUN_MAX 8
+
 	/**
 	 * @brief Size of payload for RMem messages.
 	 */
@@ -150,6 +159,7 @@
 	{
 		message_header header; /**< Message header. */
 		rpage_t blknum;        /**< Block number.   */
+		int nblocks;           /**< Run length.     */
 		int errcode;           /**< Error code.     */
 		#ifdef __RMEM_USES_MAILBOX
 		char payload[RMEM_PAYLOAD_SIZE]; /**< Payload.           */
@@ -32,7 +32,7 @@
 	 */
 	/**@{*/
 	#define SPAWNERS_NUM      2 /**< Spawn Servers */
-	#define NAME_SERVERS_NUM  1 /**< Name Servers  */
+	#define NAME_SERVERS_NUM  2 /**< Name Servers  */
 	#define RMEM_SERVERS_NUM  2 /**< RMem Servers  */
 	/**@}*/
 
@@ -54,16 +54,42 @@
 	 */
 	/**@{*/
 	#if defined(__mppa256__)
-		#define NAME_SERVER_NODE   0 /**< Name Server */
+		#define NAME_SERVER_0_NODE 0 /**< Name Server */
+		#define NAME_SERVER_1_NODE 4 /**< Name Server */
 		#define RMEM_SERVER_0_NODE 4 /**< RMem Server */
 		#define RMEM_SERVER_1_NODE 0 /**< RMem Server */
 	#elif defined(__unix64__)
-		#define NAME_SERVER_NODE    0 /**< Name Server  */
+		#define NAME_SERVER_0_NODE  0 /**< Name Server  */
+		#define NAME_SERVER_1_NODE  1 /**< Name Server  */
 		#define RMEM_SERVER_0_NODE  1 /**< RMem Server  */
 		#define RMEM_SERVER_1_NODE  0 /**< RMem Server  */
 	#endif
 	/**@}*/
 
+	/**
+	 * @brief Primary Name Server.
+	 */
+	#define NAME_SERVER_NODE NAME_SERVER_0_NODE
+
+	/**
+	 * @brief Port of the first server of a Spawn Server.
+	 *
+	 * Servers take consecutive ports, in the order in which they are
+	 * listed in the table of their Spawn Server.
+	 */
+	#define SPAWN_SERVER_PORT_FIRST 2
+
+	/**
+	 * @name Ports of RMem Servers
+	 *
+	 * Each RMem Server comes after the Name Server of its node, if
+	 * any. RMem Server 0 shares its node with the second Name Server.
+	 */
+	/**@{*/
+	#define RMEM_SERVER_0_PORT (SPAWN_SERVER_PORT_FIRST + ((NAME_SERVERS_NUM > 1) ? 1 : 0)) /**< RMem Server 0 */
+	#define RMEM_SERVER_1_PORT (SPAWN_SERVER_PORT_FIRST + 1)                                /**< RMem Server 1 */
+	/**@}*/
+
 	/**
 	 * @name Spawn rings.
 	 */
@@ -0,0 +1,341 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/runtime/inbox.h>
+#include <nanvix/runtime/stdikc.h>
+#include <nanvix/servers/message.h>
+#include <nanvix/limits/name.h>
+#include <nanvix/sys/mailbox.h>
+#include <nanvix/sys/thread.h>
+#include <nanvix/ulib.h>
+#include <posix/errno.h>
+#include <posix/stdint.h>
+
+/**
+ * @brief Number of tags.
+ */
+#define NANVIX_INBOX_TAGS_NUM 256
+
+/**
+ * @brief Length of a frame buffer (in double words).
+ */
+#define NANVIX_INBOX_FRAME_LENGTH \
+	((NANVIX_MAILBOX_MESSAGE_SIZE + sizeof(uint64_t) - 1)/sizeof(uint64_t))
+
+/**
+ * @brief Demultiplexer of a standard input mailbox.
+ *
+ * The standard input mailbox is private to a thread, and so is its
+ * demultiplexer. Thus, no locking is needed.
+ */
+static struct
+{
+	uint8_t last;                            /**< Last allocated tag. */
+	unsigned seq;                            /**< Arrival counter.    */
+	uint32_t tags[NANVIX_INBOX_TAGS_NUM/32]; /**< Allocated tags.     */
+
+	/**
+	 * @brief Messages that arrived before being read.
+	 */
+	struct
+	{
+		int used;                                 /**< Used slot?          */
+		int tag;                                  /**< Tag of the message. */
+		unsigned seq;                             /**< Time of arrival.    */
+		uint64_t data[NANVIX_INBOX_FRAME_LENGTH]; /**< Message.            */
+	} parked[NANVIX_INBOX_PARKED_MAX];
+} inboxes[THREAD_MAX + 1];
+
+/*============================================================================*
+ * nanvix_inbox_is_tagged()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not a tag is allocated.
+ *
+ * @param tid Target thread.
+ * @param tag Target tag.
+ *
+ * @returns Non-zero if @p tag is allocated, and zero otherwise.
+ */
+static inline int nanvix_inbox_is_tagged(int tid, int tag)
+{
+	return (inboxes[tid].tags[tag/32] & (1u << (tag%32)));
+}
+
+/*============================================================================*
+ * nanvix_inbox_tag()                                                         *
+ *============================================================================*/
+
+/**
+ * The nanvix_inbox_tag() function allocates a tag in the standard
+ * input mailbox of the calling thread. Tags are handed out round
+ * robin, so that a late response to an abandoned request is unlikely
+ * to match a new one.
+ */
+int nanvix_inbox_tag(void)
+{
+	int tid;
+
+	tid = kthread_self();
+
+	for (int i = 0; i < NANVIX_INBOX_TAGS_NUM; i++)
+	{
+		int tag;
+
+		/* Zero stands for untagged messages. */
+		if ((tag = ++inboxes[tid].last) == NANVIX_INBOX_UNTAGGED)
+			continue;
+
+		if (nanvix_inbox_is_tagged(tid, tag))
+			continue;
+
+		inboxes[tid].tags[tag/32] |= (1u << (tag%32));
+
+		return (tag);
+	}
+
+	return (-EAGAIN);
+}
+
+/*============================================================================*
+ * nanvix_inbox_untag()                                                       *
+ *============================================================================*/
+
+/**
+ * The nanvix_inbox_untag() function releases the tag @p tag of the
+ * standard input mailbox of the calling thread.
+ */
+int nanvix_inbox_untag(int tag)
+{
+	int tid;
+
+	/* Invalid tag. */
+	if ((tag <= NANVIX_INBOX_UNTAGGED) || (tag >= NANVIX_INBOX_TAGS_NUM))
+		return (-EINVAL);
+
+	tid = kthread_self();
+
+	/* Bad tag. */
+	if (!nanvix_inbox_is_tagged(tid, tag))
+		return (-EINVAL);
+
+	inboxes[tid].tags[tag/32] &= ~(1u << (tag%32));
+
+	/* Drop leftovers. */
+	for (int i = 0; i < NANVIX_INBOX_PARKED_MAX; i++)
+	{
+		if (inboxes[tid].parked[i].used && (inboxes[tid].parked[i].tag == tag))
+			inboxes[tid].parked[i].used = 0;
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_inbox_unpark()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Takes the oldest parked message with a given tag.
+ *
+ * @param tid Target thread.
+ * @param tag Target tag.
+ * @param buf Target buffer.
+ * @param n   Number of bytes to copy.
+ *
+ * @returns One if a message was taken, and zero otherwise.
+ */
+static int nanvix_inbox_unpark(int tid, int tag, void *buf, size_t n)
+{
+	int oldest = -1;
+
+	for (int i = 0; i < NANVIX_INBOX_PARKED_MAX; i++)
+	{
+		if (!inboxes[tid].parked[i].used || (inboxes[tid].parked[i].tag != tag))
+			continue;
+
+		if ((oldest < 0) || ((int) (inboxes[tid].parked[i].seq - inboxes[tid].parked[oldest].seq) < 0))
+			oldest = i;
+	}
+
+	if (oldest < 0)
+		return (0);
+
+	umemcpy(buf, inboxes[tid].parked[oldest].data, n);
+	inboxes[tid].parked[oldest].used = 0;
+
+	return (1);
+}
+
+/*============================================================================*
+ * nanvix_inbox_park()                                                        *
+ *============================================================================*/
+
+/**
+ * @brief Parks a message.
+ *
+ * @param tid   Target thread.
+ * @param tag   Tag of the message.
+ * @param frame Message.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure,
+ * a negative error code is returned instead.
+ */
+static int nanvix_inbox_park(int tid, int tag, const uint64_t *frame)
+{
+	for (int i = 0; i < NANVIX_INBOX_PARKED_MAX; i++)
+	{
+		if (inboxes[tid].parked[i].used)
+			continue;
+
+		inboxes[tid].parked[i].used = 1;
+		inboxes[tid].parked[i].tag = tag;
+		inboxes[tid].parked[i].seq = inboxes[tid].seq++;
+		umemcpy(inboxes[tid].parked[i].data, frame, NANVIX_MAILBOX_MESSAGE_SIZE);
+
+		return (0);
+	}
+
+	return (-ENOBUFS);
+}
+
+/*============================================================================*
+ * nanvix_inbox_classify()                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Gets the tag of a message.
+ *
+ * @param tid   Target thread.
+ * @param frame Message.
+ *
+ * @returns The tag of @p frame, NANVIX_INBOX_UNTAGGED if it is not a
+ * response of the runtime, or a negative number if it is a response
+ * to a request that was given up.
+ */
+static int nanvix_inbox_classify(int tid, const uint64_t *frame)
+{
+	const message_header *header;
+
+	header = (const message_header *) frame;
+
+	/* Application message. */
+	if ((header->magic != MESSAGE_MAGIC) || (header->tag == NANVIX_INBOX_UNTAGGED))
+		return (NANVIX_INBOX_UNTAGGED);
+
+	/* Stale response. */
+	if (!nanvix_inbox_is_tagged(tid, header->tag))
+		return (-1);
+
+	return (header->tag);
+}
+
+/*============================================================================*
+ * nanvix_inbox_is_full()                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not no more messages may be parked.
+ *
+ * @param tid Target thread.
+ *
+ * @returns Non-zero if all slots are used, and zero otherwise.
+ */
+static int nanvix_inbox_is_full(int tid)
+{
+	for (int i = 0; i < NANVIX_INBOX_PARKED_MAX; i++)
+	{
+		if (!inboxes[tid].parked[i].used)
+			return (0);
+	}
+
+	return (1);
+}
+
+/*============================================================================*
+ * nanvix_inbox_read()                                                        *
+ *============================================================================*/
+
+/**
+ * The nanvix_inbox_read() function reads @p n bytes of the next
+ * message with tag @p tag that arrives at the standard input mailbox
+ * of the calling thread. Messages with other tags that arrive in the
+ * meantime are parked, so that concurrent requests of Name, RMem and
+ * the application do not consume each other's responses. Late
+ * responses to requests that were given up are discarded.
+ *
+ * Messages are read from the mailbox only while there is room to park
+ * them. Otherwise, -ENOBUFS is returned and the next message is left
+ * in the mailbox.
+ */
+ssize_t nanvix_inbox_read(int tag, void *buf, size_t n)
+{
+	int tid;
+	ssize_t ret;
+	uint64_t frame[NANVIX_INBOX_FRAME_LENGTH];
+
+	/* Invalid tag. */
+	if ((tag < NANVIX_INBOX_UNTAGGED) || (tag >= NANVIX_INBOX_TAGS_NUM))
+		return (-EINVAL);
+
+	/* Invalid buffer. */
+	if ((buf == NULL) || (n > NANVIX_MAILBOX_MESSAGE_SIZE))
+		return (-EINVAL);
+
+	tid = kthread_self();
+
+	/* Bad tag. */
+	if ((tag != NANVIX_INBOX_UNTAGGED) && !nanvix_inbox_is_tagged(tid, tag))
+		return (-EINVAL);
+
+	/* Arrived before. */
+	if (nanvix_inbox_unpark(tid, tag, buf, n))
+		return (n);
+
+	do
+	{
+		int t;
+
+		/* No room for other messages. */
+		if (nanvix_inbox_is_full(tid))
+			return (-ENOBUFS);
+
+		if ((ret = kmailbox_read(stdinbox_get(), frame, NANVIX_MAILBOX_MESSAGE_SIZE)) < 0)
+			return (ret);
+
+		/* Nobody waits for it. */
+		if ((t = nanvix_inbox_classify(tid, frame)) < 0)
+			continue;
+
+		if (t == tag)
+			break;
+
+		uassert(nanvix_inbox_park(tid, t, frame) == 0);
+	} while (1);
+
+	umemcpy(buf, frame, n);
+
+	return (n);
+}
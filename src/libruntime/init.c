@@ -33,6 +33,7 @@
 #include <nanvix/sys/excp.h>
 #include <nanvix/sys/page.h>
 #include <nanvix/sys/perf.h>
+#include <nanvix/sys/semaphore.h>
 #include <nanvix/ulib.h>
 #include <posix/errno.h>
 
@@ -44,9 +45,160 @@ static int current_ring[THREAD_MAX + 1] = {
 };
 
 /**
- * @brief ID of exception handler thread.
+ * @brief Number of exception handler threads.
  */
-static kthread_t exception_handler_tid;
+#ifndef __RMEM_EXCP_HANDLERS_NUM
+#define RMEM_EXCP_HANDLERS_NUM 2
+#else
+#define RMEM_EXCP_HANDLERS_NUM __RMEM_EXCP_HANDLERS_NUM
+#endif
+
+/**
+ * @brief IDs of exception handler threads.
+ */
+static kthread_t exception_handler_tids[RMEM_EXCP_HANDLERS_NUM];
+
+/**
+ * @brief Page faults in flight.
+ *
+ * There is at most one fault in flight per handler thread. Faults on a
+ * page that is already being handled wait for it to complete, instead
+ * of fetching the page once again.
+ */
+static struct
+{
+	vaddr_t vaddr;                /**< Faulting page (0 if free). */
+	int nwaiters;                 /**< Number of waiting faults.  */
+	struct nanvix_semaphore done; /**< Fault handled.             */
+} inflight[RMEM_EXCP_HANDLERS_NUM];
+
+/**
+ * @brief Lock of the table of page faults in flight.
+ */
+static struct nanvix_semaphore inflight_lock;
+
+/**
+ * @brief Lock of the remote memory manager.
+ *
+ * The lock is held while cache lines are claimed and while they are
+ * linked, but not while they are fetched from remote memory.
+ */
+static struct nanvix_semaphore rfault_lock;
+
+/**
+ * @brief Faults that are fetching pages.
+ */
+static int rfault_nfetching = 0;
+
+/**
+ * @brief Faults that wait for a cache line to be filled.
+ */
+static struct
+{
+	int nwaiters;                 /**< Number of waiting faults. */
+	struct nanvix_semaphore done; /**< Line filled.              */
+} rfault_filled;
+
+/**
+ * @brief Handles a page fault in the remote memory manager.
+ *
+ * @param vaddr Faulting address.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int nanvix_exception_rfault(vaddr_t vaddr)
+{
+	int err;
+	struct rfault fault;
+
+	nanvix_semaphore_down(&rfault_lock);
+
+	/*
+	 * The page is being fetched by another fault, or all
+	 * lines are pinned by other faults. Wait for them.
+	 */
+	while (((err = nanvix_rfault_claim(vaddr, &fault)) == -EAGAIN) ||
+		((err == -EBUSY) && (rfault_nfetching > 0)))
+	{
+		rfault_filled.nwaiters++;
+		nanvix_semaphore_up(&rfault_lock);
+		nanvix_semaphore_down(&rfault_filled.done);
+		nanvix_semaphore_down(&rfault_lock);
+	}
+
+	if (err == 0)
+		rfault_nfetching++;
+
+	nanvix_semaphore_up(&rfault_lock);
+
+	if (err < 0)
+		return (err);
+
+	/* Fetch pages while other faults are handled. */
+	nanvix_rfault_fetch(&fault);
+
+	nanvix_semaphore_down(&rfault_lock);
+
+	err = nanvix_rfault_link(&fault);
+	rfault_nfetching--;
+
+	/* Wake up faults that wait for a line. */
+	for (/* noop */; rfault_filled.nwaiters > 0; rfault_filled.nwaiters--)
+		nanvix_semaphore_up(&rfault_filled.done);
+
+	nanvix_semaphore_up(&rfault_lock);
+
+	return (err);
+}
+
+/**
+ * @brief Handles a page fault.
+ *
+ * @param vaddr Faulting address.
+ */
+static void nanvix_exception_fault(vaddr_t vaddr)
+{
+	int idx = -1;
+
+	vaddr &= PAGE_MASK;
+
+	nanvix_semaphore_down(&inflight_lock);
+
+	/* Fault on this page is in flight. */
+	for (int i = 0; i < RMEM_EXCP_HANDLERS_NUM; i++)
+	{
+		if (inflight[i].vaddr == vaddr)
+		{
+			inflight[i].nwaiters++;
+			nanvix_semaphore_up(&inflight_lock);
+			nanvix_semaphore_down(&inflight[i].done);
+			return;
+		}
+
+		if (inflight[i].vaddr == 0)
+			idx = i;
+	}
+
+	uassert(idx >= 0);
+	inflight[idx].vaddr = vaddr;
+	inflight[idx].nwaiters = 0;
+
+	nanvix_semaphore_up(&inflight_lock);
+
+	uassert(nanvix_exception_rfault(vaddr) == 0);
+
+	nanvix_semaphore_down(&inflight_lock);
+
+	/* Wake up coalesced faults. */
+	for (int i = 0; i < inflight[idx].nwaiters; i++)
+		nanvix_semaphore_up(&inflight[idx].done);
+
+	inflight[idx].vaddr = 0;
+	inflight[idx].nwaiters = 0;
+
+	nanvix_semaphore_up(&inflight_lock);
+}
 
 /**
  * @brief User-space exception handler.
@@ -57,7 +209,6 @@ static kthread_t exception_handler_tid;
  */
 static void *nanvix_exception_handler(void *args)
 {
-	vaddr_t vaddr;
 	struct exception excp;
 
 	UNUSED(args);
@@ -74,8 +225,7 @@ static void *nanvix_exception_handler(void *args)
 		if (excp_pause(&excp) != 0)
 			break;
 
-		vaddr = exception_get_addr(&excp);
-		uassert(nanvix_rfault(vaddr) == 0);
+		nanvix_exception_fault(exception_get_addr(&excp));
 
 		uassert(excp_resume() == 0);
 	}
@@ -84,24 +234,25 @@ static void *nanvix_exception_handler(void *args)
 }
 
 /**
- * @brief Forces a platform-independent delay.
- *
- * @param cycles Delay in cycles.
- *
- * @author João Vicente Souto
+ * @brief Spawns exception handler threads.
  */
-static void delay(uint64_t cycles)
+static void nanvix_exception_setup(void)
 {
-	uint64_t t0, t1;
+	nanvix_semaphore_init(&inflight_lock, 1);
+	nanvix_semaphore_init(&rfault_lock, 1);
+	nanvix_semaphore_init(&rfault_filled.done, 0);
+	rfault_filled.nwaiters = 0;
+	rfault_nfetching = 0;
 
-	for (int i = 0; i < PROCESSOR_CLUSTERS_NUM; ++i)
+	for (int i = 0; i < RMEM_EXCP_HANDLERS_NUM; i++)
 	{
-		kclock(&t0);
-
-		do
-			kclock(&t1);
-		while ((t1 - t0) < cycles);
+		inflight[i].vaddr = 0;
+		inflight[i].nwaiters = 0;
+		nanvix_semaphore_init(&inflight[i].done, 0);
 	}
+
+	for (int i = 0; i < RMEM_EXCP_HANDLERS_NUM; i++)
+		uassert(kthread_create(&exception_handler_tids[i], &nanvix_exception_handler, NULL) == 0);
 }
 
 /**
@@ -134,7 +285,6 @@ int __runtime_setup(int ring)
 	if ((current_ring[tid] < SPAWN_RING_1) && (ring >= SPAWN_RING_1))
 	{
 		uprintf("[nanvix][thread %d] initalizing ring 1", tid);
-		delay(CLUSTER_FREQ);
 		uassert(__name_setup() == 0);
 	}
 
@@ -142,7 +292,6 @@ int __runtime_setup(int ring)
 	if ((current_ring[tid] < SPAWN_RING_2) && (ring >= SPAWN_RING_2))
 	{
 		uprintf("[nanvix][thread %d] initalizing ring 2", tid);
-		delay(CLUSTER_FREQ);
 		uassert(__nanvix_mailbox_setup() == 0);
 		uassert(__nanvix_portal_setup() == 0);
 	}
@@ -151,9 +300,8 @@ int __runtime_setup(int ring)
 	if ((current_ring[tid] < SPAWN_RING_4) && (ring >= SPAWN_RING_4))
 	{
 		uprintf("[nanvix][thread %d] initalizing ring 4", tid);
-		delay(CLUSTER_FREQ);
 		uassert(__nanvix_rmem_setup() == 0);
-		uassert(kthread_create(&exception_handler_tid, &nanvix_exception_handler, NULL) == 0);
+		nanvix_exception_setup();
 	}
 
 	current_ring[tid] = ring;
@@ -175,7 +323,8 @@ int __runtime_cleanup(void)
 	{
 		uprintf("[nanvix][thread %d] shutting down ring 4", tid);
 		uassert(__nanvix_rmem_cleanup() == 0);
-		uassert(kthread_join(exception_handler_tid, NULL) == 0);
+		for (int i = 0; i < RMEM_EXCP_HANDLERS_NUM; i++)
+			uassert(kthread_join(exception_handler_tids[i], NULL) == 0);
 	}
 
 	/* Initialize Ring 2. */
@@ -26,6 +26,8 @@
 #define __NEED_RESOURCE
 
 #include <nanvix/runtime/stdikc.h>
+#include <nanvix/runtime/inbox.h>
+#include <nanvix/runtime/mailbox.h>
 #include <nanvix/runtime/pm/name.h>
 #include <nanvix/sys/mailbox.h>
 #include <nanvix/sys/noc.h>
@@ -33,6 +35,7 @@
 #include <nanvix/pm.h>
 #include <nanvix/ulib.h>
 #include <posix/errno.h>
+#include <posix/stdint.h>
 
 /**
  * @brief Input named mailbox.
@@ -213,6 +216,8 @@ error0:
  */
 int nanvix_mailbox_read(int mbxid, void *buf, size_t n)
 {
+	ssize_t ret;
+
 	/* Invalid mailbox ID.*/
 	if (!nanvix_mailbox_is_valid(mbxid))
 		return (-EINVAL);
@@ -233,8 +238,13 @@ int nanvix_mailbox_read(int mbxid, void *buf, size_t n)
 	if (buf == NULL)
 		return (-EINVAL);
 
-	/* Read. */
-	if (kmailbox_read(mailboxes[mbxid].fd, buf, n) < 0)
+	/* Read, leaving responses to the runtime aside. */
+	if (mailboxes[mbxid].fd == stdinbox_get())
+		ret = nanvix_inbox_read(NANVIX_INBOX_UNTAGGED, buf, n);
+	else
+		ret = kmailbox_read(mailboxes[mbxid].fd, buf, n);
+
+	if (ret < 0)
 		return (-EINVAL);
 
 	return (0);
@@ -276,6 +286,127 @@ int nanvix_mailbox_write(int mbxid, const void *buf, size_t n)
 	return (0);
 }
 
+/*============================================================================*
+ * nanvix_mailbox_writev()                                                    *
+ *============================================================================*/
+
+/**
+ * The nanvix_mailbox_writev() function writes the @p iovcnt messages
+ * in @p iov to the mailbox @p mbxid. Consecutive messages are packed
+ * in the same frame while they fit, so that small messages do not pay
+ * the cost of a whole frame each.
+ */
+int nanvix_mailbox_writev(
+	int mbxid,
+	const struct nanvix_mailbox_iovec *iov,
+	int iovcnt
+)
+{
+	int ret;
+	int nframes;
+	size_t off;
+	uint16_t count;
+	uint16_t len;
+	uint64_t frame[(NANVIX_MAILBOX_MESSAGE_SIZE + sizeof(uint64_t) - 1)/sizeof(uint64_t)];
+
+	/* Invalid I/O vector. */
+	if ((iov == NULL) || (iovcnt < 1))
+		return (-EINVAL);
+
+	/* Invalid messages. */
+	for (int i = 0; i < iovcnt; i++)
+	{
+		if ((iov[i].iov_base == NULL) || (iov[i].iov_len > NANVIX_MAILBOX_PACKED_MAX))
+			return (-EINVAL);
+	}
+
+	nframes = 0;
+	for (int i = 0; i < iovcnt; /* noop */)
+	{
+		count = 0;
+		off = sizeof(uint16_t);
+
+		/* Do not leak stale bytes in the padding. */
+		umemset(frame, 0, sizeof(frame));
+
+		/* Pack as many messages as fit. */
+		while ((i < iovcnt) && ((off + sizeof(uint16_t) + iov[i].iov_len) <= NANVIX_MAILBOX_MESSAGE_SIZE))
+		{
+			len = iov[i].iov_len;
+			umemcpy(&((char *) frame)[off], &len, sizeof(uint16_t));
+			umemcpy(&((char *) frame)[off + sizeof(uint16_t)], iov[i].iov_base, len);
+			off += sizeof(uint16_t) + len;
+			count++;
+			i++;
+		}
+
+		umemcpy(frame, &count, sizeof(uint16_t));
+
+		if ((ret = nanvix_mailbox_write(mbxid, frame, NANVIX_MAILBOX_MESSAGE_SIZE)) < 0)
+			return (ret);
+
+		nframes++;
+	}
+
+	return (nframes);
+}
+
+/*============================================================================*
+ * nanvix_mailbox_unpack()                                                    *
+ *============================================================================*/
+
+/**
+ * The nanvix_mailbox_unpack() function parses the frame pointed to by
+ * @p frame, which was written by nanvix_mailbox_writev(), and stores
+ * the location and size of each message in @p iov.
+ */
+int nanvix_mailbox_unpack(
+	const void *frame,
+	size_t size,
+	struct nanvix_mailbox_iovec *iov,
+	int iovcnt
+)
+{
+	size_t off;
+	uint16_t count;
+	uint16_t len;
+
+	/* Invalid frame. */
+	if ((frame == NULL) || (size < sizeof(uint16_t)))
+		return (-EINVAL);
+
+	/* Invalid I/O vector. */
+	if (iov == NULL)
+		return (-EINVAL);
+
+	umemcpy(&count, frame, sizeof(uint16_t));
+
+	/* Not enough room. */
+	if (count > iovcnt)
+		return (-ENOBUFS);
+
+	off = sizeof(uint16_t);
+	for (int i = 0; i < count; i++)
+	{
+		/* Truncated frame. */
+		if ((off + sizeof(uint16_t)) > size)
+			return (-EINVAL);
+
+		umemcpy(&len, &((const char *) frame)[off], sizeof(uint16_t));
+		off += sizeof(uint16_t);
+
+		/* Truncated frame. */
+		if ((off + len) > size)
+			return (-EINVAL);
+
+		iov[i].iov_base = &((const char *) frame)[off];
+		iov[i].iov_len = len;
+		off += len;
+	}
+
+	return (count);
+}
+
 /*============================================================================*
  * mailbox_close()                                                            *
  *============================================================================*/
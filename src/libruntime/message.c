@@ -34,7 +34,7 @@
  */
 void message_header_sprint(char *str, message_header *h)
 {
-	const char *fmt = "source=%d mailbox_port=%d portal_port=%d opcode=%d";
+	const char *fmt = "source=%d mailbox_port=%d portal_port=%d opcode=%d tag=%d";
 
 	uassert(h != NULL);
 
@@ -42,7 +42,8 @@ void message_header_sprint(char *str, message_header *h)
 		h->source,
 		h->mailbox_port,
 		h->portal_port,
-		h->opcode
+		h->opcode,
+		h->tag
 	);
 }
 
@@ -62,6 +63,8 @@ void message_header_build2(
 	h->opcode = opcode;
 	h->mailbox_port = stdinbox_get_port();
 	h->portal_port = portal_port;
+	h->tag = 0;
+	h->magic = MESSAGE_MAGIC;
 }
 
 /**
@@ -66,22 +66,31 @@ struct tuple
 };
 
 /**
- * @brief Cache slot representation.
+ * @name Page cache.
+ *
+ * Metadata of cache slots is kept in compact parallel arrays, apart
+ * from the page-aligned data pool, so that lookup and eviction scans
+ * run over a few dense cache lines. Pages of a cache line lie next to
+ * each other in the data pool. The age, reference counter, pin
+ * counter and fill request of a line are stored in its first slot.
  */
-struct cache_slot
-{
-	rpage_t pgnum;
-	char pages[RMEM_BLOCK_SIZE] ALIGN(PAGE_SIZE);
-	AGE_TYPE age;
-	int ref_count;
+/**@{*/
+static rpage_t cache_pgnum[RMEM_CACHE_SIZE] = {
+	[0 ... ((RMEM_CACHE_SIZE) - 1)] = RMEM_NULL
 };
+static AGE_TYPE cache_age[RMEM_CACHE_SIZE];
+static int cache_refs[RMEM_CACHE_SIZE];
+static int cache_pins[RMEM_CACHE_SIZE];
+static int cache_filling[RMEM_CACHE_SIZE];
+static struct rmem_request cache_reqs[RMEM_CACHE_SIZE];
+static char cache_pages[RMEM_CACHE_SIZE][RMEM_BLOCK_SIZE] ALIGN(PAGE_SIZE);
+/**@}*/
 
-/*
- * @brief Page cache.
+/**
+ * @brief Computes the number of the first page of a cache line.
  */
-static struct cache_slot cache_lines[RMEM_CACHE_SIZE] = {
-	[0 ... ((RMEM_CACHE_SIZE) - 1)] = {.pgnum = RMEM_NULL, .age = 0, .ref_count = 0}
-};
+#define RMEM_CACHE_LINE_BASE(pgnum) \
+	((rpage_t)(pgnum) & ~((rpage_t)(RMEM_CACHE_BLOCK_SIZE - 1)))
 
 /**
  * @brief Discrete cache time.
@@ -112,6 +121,33 @@ static int cache_policy = __RMEM_CACHE_DEFAULT_REPLACEMENT;
  */
 static int write_policy = __RMEM_CACHE_DEFAULT_WRITE;
 
+/**
+ * @brief Handler called when a page leaves the cache.
+ */
+static rcache_evict_fn evict_handler = NULL;
+
+/*============================================================================*
+ * nanvix_rcache_drop()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Drops a page from the cache.
+ *
+ * @param slot Index of the target slot.
+ *
+ * @note The eviction handler is notified before the slot is released.
+ */
+static void nanvix_rcache_drop(int slot)
+{
+	if (cache_pgnum[slot] == RMEM_NULL)
+		return;
+
+	if (evict_handler != NULL)
+		evict_handler(cache_pgnum[slot], cache_pages[slot]);
+
+	cache_pgnum[slot] = RMEM_NULL;
+}
+
 /*============================================================================*
  * nanvix_rcache_clean()                                                      *
  *============================================================================*/
@@ -123,8 +159,10 @@ void nanvix_rcache_clean(void)
 {
 	for (int i = 0; i < RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE; i++)
 	{
-		cache_lines[i].pgnum = RMEM_NULL;
-		cache_lines[i].age = 0;
+		nanvix_rcache_drop(i);
+		cache_age[i] = 0;
+		cache_pins[i] = 0;
+		cache_filling[i] = 0;
 	}
 }
 
@@ -146,21 +184,19 @@ static struct tuple nanvix_rcache_page_search(rpage_t pgnum)
 	int pgnum_block;
 	struct tuple indexes;
 
-	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	/* Pages of a line are contiguous, so only line heads are scanned. */
+	for (int i = 0; i < RMEM_CACHE_SIZE; i += RMEM_CACHE_BLOCK_SIZE)
 	{
-		pgnum_block = (int)(pgnum) - (int)(cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum);
-		if (pgnum_block >= 0 && pgnum_block < RMEM_CACHE_BLOCK_SIZE && cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum != RMEM_NULL)
+		if (cache_pgnum[i] == RMEM_NULL)
+			continue;
+
+		pgnum_block = (int)(pgnum) - (int)(cache_pgnum[i]);
+		if (pgnum_block >= 0 && pgnum_block < RMEM_CACHE_BLOCK_SIZE && cache_pgnum[i + pgnum_block] == pgnum)
 		{
-			for (int j = 0; j < RMEM_CACHE_BLOCK_SIZE; j++)
-			{
-				if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE+j].pgnum == pgnum)
-				{
-					indexes.slot_idx = i*RMEM_CACHE_BLOCK_SIZE;
-					indexes.block_idx = j;
-					indexes.error = 0;
-					return indexes;
-				}
-			}
+			indexes.slot_idx = i;
+			indexes.block_idx = pgnum_block;
+			indexes.error = 0;
+			return indexes;
 		}
 	}
 
@@ -174,12 +210,12 @@ static int nanvix_rcache_page_search_slot(rpage_t pgnum)
 	int pgnum_block;
 
 	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
-	{ pgnum_block = (int)(pgnum) - (int)(cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum);
-		if (pgnum_block >= 0 && pgnum_block < RMEM_CACHE_BLOCK_SIZE && cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum != RMEM_NULL)
+	{ pgnum_block = (int)(pgnum) - (int)(cache_pgnum[i*RMEM_CACHE_BLOCK_SIZE]);
+		if (pgnum_block >= 0 && pgnum_block < RMEM_CACHE_BLOCK_SIZE && cache_pgnum[i*RMEM_CACHE_BLOCK_SIZE] != RMEM_NULL)
 		{
 			for (int j = 0; j < RMEM_CACHE_BLOCK_SIZE; j++)
 			{
-				if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE+j].pgnum == pgnum)
+				if (cache_pgnum[i*RMEM_CACHE_BLOCK_SIZE+j] == pgnum)
 					return (i*RMEM_CACHE_BLOCK_SIZE);
 			}
 		}
@@ -196,25 +232,25 @@ static void nanvix_rcache_aging(int idx)
 	{
 		for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
 		{
-			temp_age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age;
+			temp_age = cache_age[i*RMEM_CACHE_BLOCK_SIZE];
 			temp_age = (temp_age) >> 1;
 			if (i*RMEM_CACHE_BLOCK_SIZE == idx)
 			{
-				if (cache_lines[idx].ref_count == 1)
+				if (cache_refs[idx] == 1)
 				{
 					temp_age = (AGE_TYPE)1 << (sizeof(AGE_TYPE)*8-1) | temp_age;
-					cache_lines[idx].ref_count = (UPDATE_FREQ == 1 ? 1 : 0);
+					cache_refs[idx] = (UPDATE_FREQ == 1 ? 1 : 0);
 				} else {
 					temp_age = (AGE_TYPE)0 << (sizeof(AGE_TYPE)*8-1) | temp_age;
 				}
 			}
-			cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age = temp_age;
+			cache_age[i*RMEM_CACHE_BLOCK_SIZE] = temp_age;
 		}
 		update_count = 0;
 	} else {
-		if (cache_lines[idx].ref_count == 0)
+		if (cache_refs[idx] == 0)
 		{
-			cache_lines[idx].ref_count++;
+			cache_refs[idx]++;
 		}
 	}
 }
@@ -247,15 +283,15 @@ static int nanvix_rcache_age_update(rpage_t pgnum)
 		update_count++;
 		if (UPDATE_FREQ == update_count)
 		{
-			if (cache_lines[slot].ref_count == 1)
+			if (cache_refs[slot] == 1)
 			{
-				cache_lines[slot].age++;
-				cache_lines[slot].ref_count = (UPDATE_FREQ == 1 ? 1 : 0);
+				cache_age[slot]++;
+				cache_refs[slot] = (UPDATE_FREQ == 1 ? 1 : 0);
 			}
 			update_count = 0;
 		} else {
-			if (cache_lines[slot].ref_count == 0)
-				cache_lines[slot].ref_count++;
+			if (cache_refs[slot] == 0)
+				cache_refs[slot]++;
 		}
 	} else if (cache_policy == RMEM_CACHE_AGING) {
 		nanvix_rcache_aging(slot);
@@ -283,14 +319,14 @@ static int nanvix_rcache_age_init(rpage_t pgnum)
 		return (-EFAULT);
 
 	if (cache_policy == RMEM_CACHE_AGING) {
-		cache_lines[slot].age = 0;
-		cache_lines[slot].ref_count = 1;
+		cache_age[slot] = 0;
+		cache_refs[slot] = 1;
 		nanvix_rcache_aging(pgnum);
 	} else if (cache_policy == RMEM_CACHE_NFU) {
-		cache_lines[slot].age = 1;
-		cache_lines[slot].ref_count = 1;
+		cache_age[slot] = 1;
+		cache_refs[slot] = 1;
 	} else {
-		cache_lines[slot].age = cache_time;
+		cache_age[slot] = cache_time;
 	}
 	return 0;
 }
@@ -346,6 +382,62 @@ int random_mod(int v)
     return random_number;
 }
 
+/*============================================================================*
+ * nanvix_rcache_line_load()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Loads a cache line from remote memory.
+ *
+ * @param slot Index of the first slot of the target line.
+ * @param base Number of the first page of the target line.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure
+ * a negative error code is returned instead.
+ */
+static int nanvix_rcache_line_load(int slot, rpage_t base)
+{
+	/* Fetch all pages of the line with a single request. */
+	if (nanvix_rmem_nread(base, cache_pages[slot], RMEM_CACHE_BLOCK_SIZE) == 0)
+		return (-EFAULT);
+
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		cache_pgnum[slot + i] = (rpage_t)(base + i);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_flush()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Writes a cache line back to remote memory.
+ *
+ * @param slot Index of the first slot of the target line.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure
+ * a negative error code is returned instead.
+ */
+static int nanvix_rcache_line_flush(int slot)
+{
+	rpage_t base;
+
+	/* Nothing to do. */
+	if ((base = cache_pgnum[slot]) == RMEM_NULL)
+		return (0);
+
+	/* Line is being filled, so there is nothing to write back. */
+	if (cache_filling[slot])
+		return (0);
+
+	/* Write back all pages of the line with a single request. */
+	if (nanvix_rmem_nwrite(base, cache_pages[slot], RMEM_CACHE_BLOCK_SIZE) == 0)
+		return (-EFAULT);
+
+	return (0);
+}
+
 /*============================================================================*
  * nanvix_rcache_fifo()                                                       *
  *============================================================================*/
@@ -360,41 +452,51 @@ int random_mod(int v)
  */
 static int nanvix_rcache_fifo(void)
 {
-	int slot_idx;
-	int draw_count = 1;
+	int slot_idx = -1;
+	int draw_count = 0;
 	AGE_TYPE age;
-	AGE_TYPE min_age;
+	AGE_TYPE min_age = 0;
 
 	cache_time++;
 
 	/* Cache has space. */
 	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
 	{
-		if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum == RMEM_NULL)
+		if (cache_pgnum[i*RMEM_CACHE_BLOCK_SIZE] == RMEM_NULL)
 		    return (i*RMEM_CACHE_BLOCK_SIZE);
 	}
 
-	/* No space. Make evict. */
-	min_age = cache_lines[slot_idx = 0].age;
-	for (int i = 1; i < RMEM_CACHE_LENGTH; i++)
+	/* No space. Make evict, but skip pinned lines. */
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
 	{
-		age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age;
-		if (age < min_age)
+		if (cache_pins[i*RMEM_CACHE_BLOCK_SIZE] > 0)
+			continue;
+
+		age = cache_age[i*RMEM_CACHE_BLOCK_SIZE];
+		if ((slot_idx < 0) || (age < min_age))
 		{
 		    slot_idx = i*RMEM_CACHE_BLOCK_SIZE;
 		    min_age = age;
+			draw_count = 1;
 		} else if (age == min_age) {
 			draw_count++;
 		}
 	}
 
+	/* All lines are pinned. */
+	if (slot_idx < 0)
+		return (-EBUSY);
+
 	if (draw_count > 1)
 	{
         int random_number = random_mod(draw_count);
 		int encounter_number = 0;
 		for (int i = (slot_idx/RMEM_CACHE_BLOCK_SIZE); i < RMEM_CACHE_LENGTH; i++)
 		{
-			if ((age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age) == min_age)
+			if (cache_pins[i*RMEM_CACHE_BLOCK_SIZE] > 0)
+				continue;
+
+			if ((age = cache_age[i*RMEM_CACHE_BLOCK_SIZE]) == min_age)
 			{
 				if (encounter_number == random_number)
 					slot_idx = i*RMEM_CACHE_BLOCK_SIZE;
@@ -403,9 +505,11 @@ static int nanvix_rcache_fifo(void)
 		}
 	}
 
+	if (nanvix_rcache_line_flush(slot_idx) < 0)
+		return (-EFAULT);
+
 	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
-		if (nanvix_rcache_flush(cache_lines[slot_idx+i].pgnum) < 0)
-			return (-EFAULT);
+		nanvix_rcache_drop(slot_idx + i);
 
 	return slot_idx;
 }
@@ -436,33 +540,41 @@ static int nanvix_rcache_nfu(void)
  */
 static int nanvix_rcache_lifo(void)
 {
-	int slot_idx;
+	int slot_idx = -1;
 	int age;
-	int max_age;
+	int max_age = 0;
 
 	cache_time++;
 
 	/* Cache has space. */
 	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
 	{
-		if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum == RMEM_NULL)
+		if (cache_pgnum[i*RMEM_CACHE_BLOCK_SIZE] == RMEM_NULL)
 		    return (i*RMEM_CACHE_BLOCK_SIZE);
 	}
 
-	/* No space. Make evict. */
-	max_age = cache_lines[slot_idx = 0].age;
-	for (int i = 1; i < RMEM_CACHE_LENGTH; i++)
+	/* No space. Make evict, but skip pinned lines. */
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
 	{
-		if ((age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age) > max_age)
+		if (cache_pins[i*RMEM_CACHE_BLOCK_SIZE] > 0)
+			continue;
+
+		if (((age = cache_age[i*RMEM_CACHE_BLOCK_SIZE]) > max_age) || (slot_idx < 0))
 		{
 		    slot_idx = i*RMEM_CACHE_BLOCK_SIZE;
 		    max_age = age;
 		}
 	}
 
+	/* All lines are pinned. */
+	if (slot_idx < 0)
+		return (-EBUSY);
+
+	if (nanvix_rcache_line_flush(slot_idx) < 0)
+		return (-EFAULT);
+
 	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
-		if (nanvix_rcache_flush(cache_lines[slot_idx+i].pgnum) < 0)
-			return (-EFAULT);
+		nanvix_rcache_drop(slot_idx + i);
 
 	return slot_idx;
 }
@@ -559,6 +671,28 @@ rpage_t nanvix_rcache_alloc(void)
 	return (pgnum);
 }
 
+/*============================================================================*
+ * nanvix_rcache_alloc_line()                                                 *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_alloc_line() function allocates a run of remote
+ * pages that fills exactly one cache line.
+ */
+rpage_t nanvix_rcache_alloc_line(void)
+{
+	rpage_t pgnum;
+
+	cache_time++;
+
+	/* Forward allocation to remote memory. */
+	if ((pgnum = nanvix_rmem_nalloc(RMEM_CACHE_BLOCK_SIZE)) == RMEM_NULL)
+		return (RMEM_NULL);
+
+	stats.nallocs += RMEM_CACHE_BLOCK_SIZE;
+	return (pgnum);
+}
+
 /*============================================================================*
  * nanvix_rcache_flush()                                                      *
  *============================================================================*/
@@ -586,7 +720,7 @@ int nanvix_rcache_flush(rpage_t pgnum)
 		return (-EFAULT);
 
 	/* Write page back to remote memory. */
-	if ((err = nanvix_rmem_write(pgnum, cache_lines[slot+block].pages)) < 0)
+	if ((err = nanvix_rmem_write(pgnum, cache_pages[slot+block])) < 0)
 		return (err);
 
 #ifdef CACHE_DEBUG
@@ -610,11 +744,23 @@ int nanvix_rcache_free(rpage_t pgnum)
 	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
 		return (-EFAULT);
 
-	/* Check if target page is loaded into the cache. */
+	/*
+	 * Check if target page is loaded into the cache. If so, write
+	 * back the other pages of its line and invalidate the whole line.
+	 */
 	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
 	{
-		if (cache_lines[i].pgnum == pgnum)
-		    cache_lines[i].pgnum = RMEM_NULL;
+		int slot = i*RMEM_CACHE_BLOCK_SIZE;
+
+		if (cache_pgnum[slot] != RMEM_CACHE_LINE_BASE(pgnum))
+			continue;
+
+		if ((RMEM_CACHE_BLOCK_SIZE > 1) && (nanvix_rcache_line_flush(slot) < 0))
+			return (-EFAULT);
+
+		for (int j = 0; j < RMEM_CACHE_BLOCK_SIZE; j++)
+			nanvix_rcache_drop(slot + j);
+		cache_pins[slot] = 0;
 	}
 
 	stats.nallocs--;
@@ -622,13 +768,22 @@ int nanvix_rcache_free(rpage_t pgnum)
 }
 
 /*============================================================================*
- * nanvix_rcache_get()                                                        *
+ * nanvix_rcache_lookup()                                                     *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Gets a remote page into the page cache.
+ *
+ * @param pgnum Number of the target page.
+ * @param fetch Fetch contents of the page on a miss?
+ *
+ * @returns Upon successful completion, a pointer to the cached page
+ * is returned. Upon failure, a @p NULL pointer is returned instead.
+ *
+ * @note When @p fetch is zero, a missing page is installed without
+ * reading it from remote memory, and its contents are undefined.
  */
-void *nanvix_rcache_get(rpage_t pgnum)
+static void *nanvix_rcache_lookup(rpage_t pgnum, int fetch)
 {
 	int err;
 	int evict_idx;
@@ -650,44 +805,61 @@ void *nanvix_rcache_get(rpage_t pgnum)
 	{
 		if (error >= 0)
 		{
+			/* Line is being filled. */
+			if (cache_filling[slot])
+				return (NULL);
+
 			stats.nhits++;
 			nanvix_rcache_age_update(pgnum);
-			cache_lines[slot].ref_count++;
-			return (cache_lines[slot+block].pages);
+			cache_refs[slot]++;
+			return (cache_pages[slot+block]);
 		}
 
 		stats.nmisses++;
 		if ((evict_idx = nanvix_rcache_replacement_policies()) < 0)
 			return (NULL);
-		/* Load page remote page. */
-		for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+
+		/* Load the whole cache line. */
+		if (fetch)
 		{
-			if ((err = nanvix_rmem_read((rpage_t)(pgnum+i), cache_lines[evict_idx+i].pages)) < 0)
+			if (nanvix_rcache_line_load(evict_idx, RMEM_CACHE_LINE_BASE(pgnum)) < 0)
 				return (NULL);
-			cache_lines[evict_idx+i].pgnum = (rpage_t)(pgnum+i);
 		}
 
-		cache_lines[evict_idx].ref_count++;
+		/* Install the line without reading it. */
+		else
+		{
+			for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+				cache_pgnum[evict_idx + i] = (rpage_t)(RMEM_CACHE_LINE_BASE(pgnum) + i);
+		}
+
+		cache_refs[evict_idx]++;
 		nanvix_rcache_age_init(pgnum);
 
-		ptr = cache_lines[evict_idx].pages;
+		ptr = cache_pages[evict_idx + (pgnum - RMEM_CACHE_LINE_BASE(pgnum))];
 	}
 	/* Bypass mode. */
 	else
 	{
 		stats.nmisses++;
 
-		if (cache_lines[0].pgnum != RMEM_NULL)
+		if (cache_pgnum[0] != RMEM_NULL)
 		{
-			if (nanvix_rcache_flush(cache_lines[0].pgnum))
+			if (nanvix_rcache_flush(cache_pgnum[0]))
 				return (NULL);
+
+			if (cache_pgnum[0] != pgnum)
+				nanvix_rcache_drop(0);
 		}
 
-		if ((err = nanvix_rmem_read(pgnum, cache_lines[0].pages)) < 0)
-			return (NULL);
+		if (fetch)
+		{
+			if ((err = nanvix_rmem_read(pgnum, cache_pages[0])) < 0)
+				return (NULL);
+		}
 
-		cache_lines[0].pgnum = pgnum;
-		ptr = cache_lines[0].pages;
+		cache_pgnum[0] = pgnum;
+		ptr = cache_pages[0];
 	}
 
 #ifdef CACHE_DEBUG
@@ -697,6 +869,568 @@ void *nanvix_rcache_get(rpage_t pgnum)
 	return (ptr);
 }
 
+/*============================================================================*
+ * nanvix_rcache_get()                                                        *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_get() function gets the remote page @p pgnum into
+ * the page cache. On a miss, a line is evicted according to the
+ * replacement policy, and the whole line that holds @p pgnum is
+ * fetched from remote memory. On success, a reference to the line is
+ * taken, and the caller should drop it with nanvix_rcache_put(). A
+ * @p NULL pointer is returned if the line that holds @p pgnum is still
+ * being filled by another thread, if no line can be evicted, or if the
+ * fetch fails. In bypass mode, the page goes through a single slot
+ * and no reference is taken.
+ */
+void *nanvix_rcache_get(rpage_t pgnum)
+{
+	return (nanvix_rcache_lookup(pgnum, 1));
+}
+
+/*============================================================================*
+ * nanvix_rcache_install()                                                    *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_install() function gets the remote page @p pgnum
+ * into the page cache for a full overwrite. On a miss the page is not
+ * fetched from remote memory, because all of its contents are about
+ * to be replaced. Cached pages are always written back on eviction, so
+ * the installed page needs no extra bookkeeping to be treated as
+ * dirty. Lines that span several pages are still fetched, as the
+ * neighbours of @p pgnum are not overwritten.
+ */
+void *nanvix_rcache_install(rpage_t pgnum)
+{
+	return (nanvix_rcache_lookup(pgnum, (RMEM_CACHE_BLOCK_SIZE > 1)));
+}
+
+/*============================================================================*
+ * nanvix_rcache_invalidate()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Invalidates the cached copy of a remote page.
+ *
+ * @param pgnum     Number of the target page.
+ * @param writeback Write the page back before invalidating it?
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure
+ * a negative error code is returned instead.
+ *
+ * @note The other pages of the line are always written back, as they
+ * are invalidated too.
+ */
+static int nanvix_rcache_invalidate(rpage_t pgnum, int writeback)
+{
+	struct tuple idx;
+
+	/* Bypass mode. */
+	if (cache_policy == RMEM_CACHE_BYPASS)
+	{
+		if (cache_pgnum[0] != pgnum)
+			return (0);
+
+		if (writeback && (nanvix_rmem_write(cache_pgnum[0], cache_pages[0]) == 0))
+			return (-EFAULT);
+
+		nanvix_rcache_drop(0);
+
+		return (0);
+	}
+
+	/* Not cached. */
+	if ((idx = nanvix_rcache_page_search(pgnum)).error < 0)
+		return (0);
+
+	/* Pinned line. */
+	if (cache_pins[idx.slot_idx] > 0)
+		return (-EBUSY);
+
+	if (writeback || (RMEM_CACHE_BLOCK_SIZE > 1))
+	{
+		if (nanvix_rcache_line_flush(idx.slot_idx) < 0)
+			return (-EFAULT);
+	}
+
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		nanvix_rcache_drop(idx.slot_idx + i);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_evict()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_evict() function writes back and evicts the cache
+ * line that holds the remote page @p pgnum, if any.
+ */
+int nanvix_rcache_evict(rpage_t pgnum)
+{
+	cache_time++;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	return (nanvix_rcache_invalidate(pgnum, 1));
+}
+
+/*============================================================================*
+ * nanvix_rcache_prefetch()                                                   *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_prefetch() function loads the remote page @p
+ * pgnum into the page cache, without taking a reference to it.
+ */
+int nanvix_rcache_prefetch(rpage_t pgnum)
+{
+	struct tuple idx;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Nowhere to keep the page. */
+	if (cache_policy == RMEM_CACHE_BYPASS)
+		return (-ENOTSUP);
+
+	/* Already cached. */
+	if (nanvix_rcache_page_search(pgnum).error >= 0)
+		return (0);
+
+	if (nanvix_rcache_lookup(pgnum, 1) == NULL)
+		return (-EFAULT);
+
+	/* Drop reference taken above. */
+	idx = nanvix_rcache_page_search(pgnum);
+	uassert(idx.error >= 0);
+	cache_refs[idx.slot_idx]--;
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_claim()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_claim() function claims a cache line for the
+ * remote page @p pgnum, if the page is not cached yet. The claimed
+ * line is pinned and marked as being filled, so that it is neither
+ * evicted nor handed out until nanvix_rcache_release() is called on
+ * it. Dirty lines that are evicted to make room for it are written
+ * back before the function returns.
+ */
+int nanvix_rcache_claim(rpage_t pgnum, int *line)
+{
+	int slot;
+	rpage_t base;
+	struct tuple idx;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+	if (RMEM_BLOCK_SERVER(pgnum) >= RMEM_SERVERS_NUM)
+		return (-EFAULT);
+
+	/* Invalid line. */
+	if (line == NULL)
+		return (-EINVAL);
+
+	/* Nowhere to keep the page. */
+	if (cache_policy == RMEM_CACHE_BYPASS)
+		return (-ENOTSUP);
+
+	/* Already cached. */
+	if ((idx = nanvix_rcache_page_search(pgnum)).error >= 0)
+		return (cache_filling[idx.slot_idx] ? -EAGAIN : 0);
+
+	stats.nmisses++;
+	if ((slot = nanvix_rcache_replacement_policies()) < 0)
+		return (slot);
+
+	base = RMEM_CACHE_LINE_BASE(pgnum);
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		cache_pgnum[slot + i] = (rpage_t)(base + i);
+
+	cache_filling[slot] = 1;
+	cache_pins[slot]++;
+	cache_reqs[slot].tag = -1;
+	cache_reqs[slot].ret = 0;
+
+	*line = slot;
+
+	return (1);
+}
+
+/*============================================================================*
+ * nanvix_rcache_fetch_async()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Sends the request that fills a claimed cache line.
+ *
+ * @param line Index of the first slot of the target line.
+ */
+static void nanvix_rcache_fetch_async(int line)
+{
+	nanvix_rmem_nread_async(
+		&cache_reqs[line],
+		cache_pgnum[line],
+		cache_pages[line],
+		RMEM_CACHE_BLOCK_SIZE
+	);
+}
+
+/*============================================================================*
+ * nanvix_rcache_fetch_wait()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Waits for the request that fills a claimed cache line.
+ *
+ * @param line Index of the first slot of the target line.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure
+ * a negative error code is returned instead.
+ */
+static int nanvix_rcache_fetch_wait(int line)
+{
+	return ((nanvix_rmem_wait(&cache_reqs[line]) == 0) ? -EFAULT : 0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_fillv()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_fillv() function fills the claimed cache lines
+ * listed in @p lines. Requests are sent in rounds. In each round, one
+ * request is sent to each server that has lines left, and only then
+ * are they waited for, so that the servers work in parallel. A server
+ * is never sent a second request while the first one is outstanding,
+ * as it could be blocked on the transfer of the first one.
+ */
+int nanvix_rcache_fillv(const int *lines, int n)
+{
+	int err = 0;
+	int nleft;
+	char pending[RMEM_CACHE_LENGTH];
+
+	/* Invalid list of lines. */
+	if ((lines == NULL) || (n < 0) || (n > RMEM_CACHE_LENGTH))
+		return (-EINVAL);
+
+	for (int i = 0; i < n; i++)
+	{
+		/* Invalid line. */
+		if ((lines[i] < 0) || (lines[i] >= RMEM_CACHE_SIZE) || !cache_filling[lines[i]])
+			return (-EINVAL);
+
+		pending[i] = 1;
+	}
+
+	for (nleft = n; nleft > 0; /* noop */)
+	{
+		int issued[RMEM_SERVERS_NUM];
+
+		for (int i = 0; i < RMEM_SERVERS_NUM; i++)
+			issued[i] = -1;
+
+		/* Send at most one request per server. */
+		for (int i = 0; i < n; i++)
+		{
+			int serverid;
+
+			if (!pending[i])
+				continue;
+
+			/* Server is busy in this round. */
+			if (issued[serverid = RMEM_BLOCK_SERVER(cache_pgnum[lines[i]])] >= 0)
+				continue;
+
+			pending[i] = 0;
+			nleft--;
+			issued[serverid] = lines[i];
+			nanvix_rcache_fetch_async(lines[i]);
+		}
+
+		/* Wait for requests. */
+		for (int i = 0; i < RMEM_SERVERS_NUM; i++)
+		{
+			if ((issued[i] >= 0) && (nanvix_rcache_fetch_wait(issued[i]) < 0))
+				err = -EFAULT;
+		}
+	}
+
+	return (err);
+}
+
+/*============================================================================*
+ * nanvix_rcache_release()                                                    *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_release() function releases the claimed cache
+ * line @p line. If the line could not be filled, it is dropped.
+ */
+int nanvix_rcache_release(int line)
+{
+	/* Invalid line. */
+	if ((line < 0) || (line >= RMEM_CACHE_SIZE) || !cache_filling[line])
+		return (-EINVAL);
+
+	cache_filling[line] = 0;
+	cache_pins[line]--;
+
+	/* Failed to fill the line. */
+	if (cache_reqs[line].ret == 0)
+	{
+		for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+			nanvix_rcache_drop(line + i);
+
+		return (-EFAULT);
+	}
+
+	nanvix_rcache_age_init(cache_pgnum[line]);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_fetchv()                                                     *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_fetchv() function loads the remote pages listed
+ * in @p pgnums into the page cache, without taking references to
+ * them. A line is claimed for each missing page, and then all lines
+ * are filled at once. Lines are evicted while claiming, thus no write
+ * back is issued while a read is outstanding.
+ */
+int nanvix_rcache_fetchv(const rpage_t *pgnums, int n)
+{
+	int err = 0;
+	int nlines = 0;
+	int lines[RMEM_CACHE_LENGTH];
+
+	/* Invalid list of pages. */
+	if ((pgnums == NULL) || (n < 0) || (n > RMEM_CACHE_LENGTH))
+		return (-EINVAL);
+
+	/* Nowhere to keep the pages. */
+	if (cache_policy == RMEM_CACHE_BYPASS)
+		return (-ENOTSUP);
+
+	/* Claim lines. */
+	for (int i = 0; i < n; i++)
+	{
+		int ret;
+
+		if ((ret = nanvix_rcache_claim(pgnums[i], &lines[nlines])) > 0)
+			nlines++;
+
+		/* Not cached nor being filled. */
+		else if ((ret < 0) && (ret != -EAGAIN))
+			err = ret;
+	}
+
+	nanvix_rcache_fillv(lines, nlines);
+
+	/* Release lines. */
+	for (int i = 0; i < nlines; i++)
+	{
+		if (nanvix_rcache_release(lines[i]) < 0)
+			err = -EFAULT;
+	}
+
+	return (err);
+}
+
+/*============================================================================*
+ * nanvix_rcache_stream_read()                                                *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_stream_read() function reads @p npages consecutive
+ * remote pages, starting at @p pgnum, straight into the buffer pointed
+ * to by @p buf, with a single request and without staging them in the
+ * page cache. Cached copies of these pages are written back and
+ * evicted first.
+ */
+int nanvix_rcache_stream_read(rpage_t pgnum, void *buf, int npages)
+{
+	int err;
+
+	cache_time++;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Invalid run. */
+	if ((npages <= 0) || (npages > RMEM_RUN_MAX))
+		return (-EINVAL);
+	if ((RMEM_BLOCK_NUM(pgnum) + npages) > RMEM_NUM_BLOCKS)
+		return (-EFAULT);
+
+	/* Invalid buffer. */
+	if (buf == NULL)
+		return (-EINVAL);
+
+	/* Cached copies hold the most recent data. */
+	for (int i = 0; i < npages; i++)
+	{
+		if ((err = nanvix_rcache_invalidate(pgnum + i, 1)) < 0)
+			return (err);
+	}
+
+	stats.nmisses += npages;
+
+	if (nanvix_rmem_nread(pgnum, buf, npages) == 0)
+		return (-EFAULT);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_stream_write()                                               *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_stream_write() function writes the buffer pointed
+ * to by @p buf over @p npages consecutive remote pages, starting at @p
+ * pgnum, with a single request and without staging them in the page
+ * cache. Cached copies of these pages are dropped first, as they are
+ * about to become stale.
+ */
+int nanvix_rcache_stream_write(rpage_t pgnum, const void *buf, int npages)
+{
+	int err;
+
+	cache_time++;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Invalid run. */
+	if ((npages <= 0) || (npages > RMEM_RUN_MAX))
+		return (-EINVAL);
+	if ((RMEM_BLOCK_NUM(pgnum) + npages) > RMEM_NUM_BLOCKS)
+		return (-EFAULT);
+
+	/* Invalid buffer. */
+	if (buf == NULL)
+		return (-EINVAL);
+
+	/* Drop stale copies. */
+	for (int i = 0; i < npages; i++)
+	{
+		if ((err = nanvix_rcache_invalidate(pgnum + i, 0)) < 0)
+			return (err);
+	}
+
+	stats.nmisses += npages;
+
+	if (nanvix_rmem_nwrite(pgnum, buf, npages) == 0)
+		return (-EFAULT);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_read()                                                       *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_read() function reads @p npages consecutive remote
+ * pages, starting at @p pgnum, straight into the buffer pointed to by
+ * @p buf. This is only supported in bypass mode.
+ *
+ * @see nanvix_rcache_stream_read().
+ */
+int nanvix_rcache_read(rpage_t pgnum, void *buf, int npages)
+{
+	/* Only meaningful in bypass mode. */
+	if (cache_policy != RMEM_CACHE_BYPASS)
+		return (-ENOTSUP);
+
+	return (nanvix_rcache_stream_read(pgnum, buf, npages));
+}
+
+/*============================================================================*
+ * nanvix_rcache_write()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_write() function writes the buffer pointed to by
+ * @p buf over @p npages consecutive remote pages, starting at @p
+ * pgnum. This is only supported in bypass mode.
+ *
+ * @see nanvix_rcache_stream_write().
+ */
+int nanvix_rcache_write(rpage_t pgnum, const void *buf, int npages)
+{
+	/* Only meaningful in bypass mode. */
+	if (cache_policy != RMEM_CACHE_BYPASS)
+		return (-ENOTSUP);
+
+	return (nanvix_rcache_stream_write(pgnum, buf, npages));
+}
+
+/*============================================================================*
+ * nanvix_rcache_peek()                                                       *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_peek() function returns the cached copy of the
+ * remote page @p pgnum, if any. The page is neither fetched nor
+ * referenced, and neither statistics nor ages are updated.
+ */
+void *nanvix_rcache_peek(rpage_t pgnum)
+{
+	struct tuple idx;
+
+	/* Invalid page number. */
+	if (pgnum == RMEM_NULL)
+		return (NULL);
+
+	/* Only the current page is valid in bypass mode. */
+	if (cache_policy == RMEM_CACHE_BYPASS)
+		return ((cache_pgnum[0] == pgnum) ? cache_pages[0] : NULL);
+
+	idx = nanvix_rcache_page_search(pgnum);
+	if (idx.error < 0)
+		return (NULL);
+
+	/* Line is being filled. */
+	if (cache_filling[idx.slot_idx])
+		return (NULL);
+
+	return (cache_pages[idx.slot_idx + idx.block_idx]);
+}
+
+/*============================================================================*
+ * nanvix_rcache_evict_handler()                                              *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_evict_handler() function registers @p fn to be
+ * called whenever a page leaves the page cache, that is when its line
+ * is evicted, freed or cleaned.
+ */
+void nanvix_rcache_evict_handler(rcache_evict_fn fn)
+{
+	evict_handler = fn;
+}
+
 /*============================================================================*
  * nanvix_rcache_put()                                                        *
  *============================================================================*/
@@ -727,24 +1461,24 @@ int nanvix_rcache_put(rpage_t pgnum, int strike)
 #endif
 
 		if (cache_policy == RMEM_CACHE_NFU)
-			cache_lines[slot].age += strike;
+			cache_age[slot] += strike;
 
-		if (cache_lines[slot].ref_count <= 0)
+		if (cache_refs[slot] <= 0)
 			return (-EFAULT);
 
 		if ((write_policy == RMEM_CACHE_WRITE_THROUGH) && (nanvix_rcache_flush(pgnum) < 0))
 			return (-EFAULT);
 
-		cache_lines[slot].ref_count--;
+		cache_refs[slot]--;
 	}
 	else
 	{
 		int err;
 
-		if (cache_lines[0].pgnum != pgnum)
+		if (cache_pgnum[0] != pgnum)
 			return (-EFAULT);
 
-		if ((err = nanvix_rmem_write(pgnum, cache_lines[0].pages)) < 0)
+		if ((err = nanvix_rmem_write(pgnum, cache_pages[0])) < 0)
 			return (err);
 	}
 
@@ -754,6 +1488,76 @@ int nanvix_rcache_put(rpage_t pgnum, int strike)
 	return (0);
 }
 
+/*============================================================================*
+ * nanvix_rcache_pin()                                                        *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_pin() function pins the remote page @p pgnum in
+ * the page cache, loading it if needed. Pins are tracked per cache
+ * line and are kept apart from the reference counter, which is reused
+ * as a reference bit by the NFU and aging policies.
+ */
+int nanvix_rcache_pin(rpage_t pgnum)
+{
+	struct tuple idx;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EINVAL);
+
+	/* Bypass mode has no resident lines to pin. */
+	if (cache_policy == RMEM_CACHE_BYPASS)
+		return (-ENOTSUP);
+
+	/* Bring the page in. */
+	if (nanvix_rcache_get(pgnum) == NULL)
+		return (-EFAULT);
+
+	idx = nanvix_rcache_page_search(pgnum);
+	uassert(idx.error >= 0);
+
+	/* Pin line and drop reference taken above. */
+	cache_pins[idx.slot_idx]++;
+	cache_refs[idx.slot_idx]--;
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_unpin()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rcache_unpin() function releases a pin previously placed
+ * on the remote page @p pgnum by nanvix_rcache_pin(). The page becomes
+ * eligible for eviction once all pins on its cache line are released.
+ */
+int nanvix_rcache_unpin(rpage_t pgnum)
+{
+	struct tuple idx;
+
+	cache_time++;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EINVAL);
+
+	idx = nanvix_rcache_page_search(pgnum);
+
+	/* Page not cached. */
+	if (idx.error < 0)
+		return (-EFAULT);
+
+	/* Page not pinned. */
+	if (cache_pins[idx.slot_idx] <= 0)
+		return (-EINVAL);
+
+	cache_pins[idx.slot_idx]--;
+
+	return (0);
+}
+
 /*============================================================================*
  * nanvix_rcache_setup()                                                      *
  *============================================================================*/
@@ -775,9 +1579,11 @@ int __nanvix_rcache_setup(void)
 	/* Page cache lines. */
 	for (int i = 0; i < RMEM_CACHE_SIZE; i++)
 	{
-		cache_lines[i].pgnum = RMEM_NULL;
-		cache_lines[i].age = 0;
-		cache_lines[i].ref_count = 0;
+		cache_pgnum[i] = RMEM_NULL;
+		cache_age[i] = 0;
+		cache_refs[i] = 0;
+		cache_pins[i] = 0;
+		cache_filling[i] = 0;
 	}
 
 	initialized = 1;
@@ -33,6 +33,6 @@ struct rmem_servers_info
 	int portnum;
 	const char *name;
 } rmem_servers[RMEM_SERVERS_NUM] = {
-	{ RMEM_SERVER_0_NODE, 2, "/rmem0" },
-	{ RMEM_SERVER_1_NODE, 3, "/rmem1" },
+	{ RMEM_SERVER_0_NODE, RMEM_SERVER_0_PORT, "/rmem0" },
+	{ RMEM_SERVER_1_NODE, RMEM_SERVER_1_PORT, "/rmem1" },
 };
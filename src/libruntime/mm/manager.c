@@ -20,7 +20,9 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#define __NEED_RMEM_SERVICE
 #define __NEED_RMEM_CACHE
+#define __NEED_MM_MANAGER
 
 #include <nanvix/runtime/rmem.h>
 #include <nanvix/sys/page.h>
@@ -31,9 +33,56 @@
 #include <stdint.h>
 
 /**
- * @brief Length of remote memory table.
+ * @brief Number of pages in the remote memory address space.
  */
-#define RMEM_TABLE_LENGTH 1024
+#define RMEM_VMEM_LENGTH (RMEM_SIZE/RMEM_BLOCK_SIZE)
+
+/**
+ * @name Remote memory table.
+ *
+ * The remote memory table is a fixed two-level table. The directory
+ * spans the whole remote memory address space, which is bounded by
+ * RMEM_SIZE, and thus it never needs to grow. Second-level tables are
+ * taken from a static pool, because the runtime has no local heap to
+ * allocate them from: the application heap itself lives in remote
+ * memory.
+ */
+/**@{*/
+#define RMEM_TABLE_L2_SHIFT  9                                            /**< Shift of second level.    */
+#define RMEM_TABLE_L2_LENGTH (1 << RMEM_TABLE_L2_SHIFT)                   /**< Second level length.      */
+#define RMEM_TABLE_L1_LENGTH (RMEM_VMEM_LENGTH >> RMEM_TABLE_L2_SHIFT)    /**< Directory length.         */
+/**@}*/
+
+/**
+ * @brief Number of second-level tables.
+ *
+ * By default, the pool is big enough to map the whole address space,
+ * and it takes as much storage as a flat table would. Configurations
+ * that map a small part of the address space may shrink it, in which
+ * case mappings fail with -ENOMEM once the pool runs out.
+ */
+#ifndef __RMEM_TABLE_L2_MAX
+#define RMEM_TABLE_L2_MAX RMEM_TABLE_L1_LENGTH
+#else
+#define RMEM_TABLE_L2_MAX __RMEM_TABLE_L2_MAX
+#endif
+
+/**
+ * @brief Maximum number of remote memory regions.
+ */
+#ifndef __RMEM_REGIONS_MAX
+#define RMEM_REGIONS_MAX 256
+#else
+#define RMEM_REGIONS_MAX __RMEM_REGIONS_MAX
+#endif
+
+/**
+ * @brief Reserved page.
+ *
+ * Pages of a reserved region are backed by remote memory only when
+ * they are first touched.
+ */
+#define RMEM_VMEM_RESERVED ((rpage_t) -1)
 
 /**
  * @brief Computes a remote address.
@@ -46,16 +95,280 @@
 #define RADDR_INV(x) ((vaddr_t)(x) - UBASE_VIRT)
 
 /**
- * @brief Remote memory table
+ * @brief Second-level remote memory table.
+ */
+struct rmem_table_l2
+{
+	int nused;                            /**< Mapped entries. */
+	rpage_t pgnums[RMEM_TABLE_L2_LENGTH]; /**< Remote pages.   */
+};
+
+/**
+ * @brief Pool of second-level tables.
+ */
+static struct rmem_table_l2 rmem_tables[RMEM_TABLE_L2_MAX];
+
+/**
+ * @brief Remote memory table (directory).
+ *
+ * Second-level tables are attached from the pool on demand, as regions
+ * are mapped, and they are given back to it once they become empty.
+ */
+static struct rmem_table_l2 *rmem_table[RMEM_TABLE_L1_LENGTH] = {
+	[0 ... (RMEM_TABLE_L1_LENGTH - 1)] = NULL
+};
+
+/**
+ * @brief Remote memory region.
  */
-static rpage_t rmem_table[RMEM_TABLE_LENGTH] = {
-	[0 ... (RMEM_TABLE_LENGTH - 1)] = RMEM_NULL
+struct rmem_region
+{
+	int base;   /**< First page.                */
+	int npages; /**< Number of pages.           */
+	int length; /**< Number of requested pages. */
+	int advice; /**< Access pattern.            */
 };
 
 /**
- * @brief Current break value for remote memory.
+ * @brief Allocated remote memory regions (sorted by base address).
+ *
+ * Holes between consecutive regions are the free areas of the remote
+ * memory address space.
+ */
+static struct
+{
+	int nregions;                                 /**< Number of regions. */
+	struct rmem_region regions[RMEM_REGIONS_MAX]; /**< Regions.           */
+} rmem_regions = { 0, };
+
+/*============================================================================*
+ * nanvix_vmem_translate()                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Translates a page of the remote memory address space.
+ *
+ * @param page Target page.
+ *
+ * @returns The number of the remote page that backs @p page is
+ * returned. If @p page is not mapped, @p RMEM_NULL is returned
+ * instead.
+ */
+static rpage_t nanvix_vmem_translate(raddr_t page)
+{
+	struct rmem_table_l2 *l2;
+
+	if (page >= RMEM_VMEM_LENGTH)
+		return (RMEM_NULL);
+
+	if ((l2 = rmem_table[page >> RMEM_TABLE_L2_SHIFT]) == NULL)
+		return (RMEM_NULL);
+
+	return (l2->pgnums[page & (RMEM_TABLE_L2_LENGTH - 1)]);
+}
+
+/*============================================================================*
+ * nanvix_vmem_map()                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Maps a page of the remote memory address space.
+ *
+ * @param page  Target page.
+ * @param pgnum Remote page that backs @p page.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int nanvix_vmem_map(raddr_t page, rpage_t pgnum)
+{
+	struct rmem_table_l2 **l2;
+
+	l2 = &rmem_table[page >> RMEM_TABLE_L2_SHIFT];
+
+	/* Attach a second-level table. */
+	if (*l2 == NULL)
+	{
+		for (int i = 0; i < RMEM_TABLE_L2_MAX; i++)
+		{
+			if (rmem_tables[i].nused == 0)
+			{
+				*l2 = &rmem_tables[i];
+				break;
+			}
+		}
+
+		/* No table available. */
+		if (*l2 == NULL)
+			return (-ENOMEM);
+
+		for (int i = 0; i < RMEM_TABLE_L2_LENGTH; i++)
+			(*l2)->pgnums[i] = RMEM_NULL;
+	}
+
+	/* Fill in a reserved entry. */
+	if ((*l2)->pgnums[page & (RMEM_TABLE_L2_LENGTH - 1)] == RMEM_NULL)
+		(*l2)->nused++;
+
+	(*l2)->pgnums[page & (RMEM_TABLE_L2_LENGTH - 1)] = pgnum;
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_vmem_unmap()                                                        *
+ *============================================================================*/
+
+/**
+ * @brief Unmaps a page of the remote memory address space.
+ *
+ * @param page Target page.
+ */
+static void nanvix_vmem_unmap(raddr_t page)
+{
+	struct rmem_table_l2 **l2;
+
+	l2 = &rmem_table[page >> RMEM_TABLE_L2_SHIFT];
+
+	uassert(*l2 != NULL);
+	uassert((*l2)->pgnums[page & (RMEM_TABLE_L2_LENGTH - 1)] != RMEM_NULL);
+
+	(*l2)->pgnums[page & (RMEM_TABLE_L2_LENGTH - 1)] = RMEM_NULL;
+
+	/* Detach empty table. */
+	if (--(*l2)->nused == 0)
+		*l2 = NULL;
+}
+
+/*============================================================================*
+ * nanvix_vmem_region_search()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Searches for the region that starts at or before a page.
+ *
+ * @param page Target page.
+ *
+ * @returns The index of the last region whose base is not greater
+ * than @p page is returned. If there is no such region, -1 is
+ * returned instead.
+ */
+static int nanvix_vmem_region_search(int page)
+{
+	int lo = 0;
+	int hi = rmem_regions.nregions - 1;
+	int idx = -1;
+
+	/* Binary search. */
+	while (lo <= hi)
+	{
+		int mid = lo + (hi - lo)/2;
+
+		if (rmem_regions.regions[mid].base <= page)
+		{
+			idx = mid;
+			lo = mid + 1;
+		}
+		else
+			hi = mid - 1;
+	}
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_vmem_region_alloc()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Allocates a region of the remote memory address space.
+ *
+ * @param npages Number of pages in the region.
+ * @param length Number of pages that were requested.
+ *
+ * @returns Upon successful completion, the first page of the new
+ * region is returned. Upon failure, a negative error code is returned
+ * instead.
+ *
+ * @note Regions are placed in the first hole that fits them.
+ */
+static int nanvix_vmem_region_alloc(int npages, int length)
+{
+	int idx;
+	int base = 1;
+
+	/* Invalid region size. */
+	if (npages <= 0)
+		return (-EINVAL);
+
+	/* Too many regions. */
+	if (rmem_regions.nregions == RMEM_REGIONS_MAX)
+		return (-ENOMEM);
+
+	/* First fit. */
+	for (idx = 0; idx < rmem_regions.nregions; idx++)
+	{
+		if ((rmem_regions.regions[idx].base - base) >= npages)
+			break;
+
+		base = rmem_regions.regions[idx].base + rmem_regions.regions[idx].npages;
+	}
+
+	/* Not enough memory.*/
+	if ((base + npages) > RMEM_VMEM_LENGTH)
+		return (-ENOMEM);
+
+	/* Keep regions sorted. */
+	for (int i = rmem_regions.nregions; i > idx; i--)
+		rmem_regions.regions[i] = rmem_regions.regions[i - 1];
+
+	rmem_regions.regions[idx].base = base;
+	rmem_regions.regions[idx].npages = npages;
+	rmem_regions.regions[idx].length = length;
+	rmem_regions.regions[idx].advice = RMEM_ADVICE_NORMAL;
+	rmem_regions.nregions++;
+
+	return (base);
+}
+
+/*============================================================================*
+ * nanvix_vmem_region_free()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Releases a region of the remote memory address space.
+ *
+ * @param idx Index of the target region.
+ */
+static void nanvix_vmem_region_free(int idx)
+{
+	rmem_regions.nregions--;
+
+	for (int i = idx; i < rmem_regions.nregions; i++)
+		rmem_regions.regions[i] = rmem_regions.regions[i + 1];
+}
+
+/*============================================================================*
+ * nanvix_vmem_advice()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Gets the access pattern of a page.
+ *
+ * @param page Target page.
+ *
+ * @returns The access pattern advised for the region of @p page is
+ * returned.
  */
-static int rbrk = 1;
+static int nanvix_vmem_advice(raddr_t page)
+{
+	int idx;
+
+	if ((idx = nanvix_vmem_region_search(page)) < 0)
+		return (RMEM_ADVICE_NORMAL);
+
+	return (rmem_regions.regions[idx].advice);
+}
 
 /*============================================================================*
  * nanvix_vmem_lookup()                                                       *
@@ -83,11 +396,11 @@ static int nanvix_vmem_lookup(raddr_t *base, raddr_t *offset, const void *ptr)
 	_base = ((raddr_t) ptr) >> RMEM_BLOCK_SHIFT;
 
 	/* Invalid remote memory area. */
-	if (_base >= RMEM_TABLE_LENGTH)
+	if (_base >= RMEM_VMEM_LENGTH)
 		return (-EINVAL);
 
 	/* Bad remote memory address. */
-	if (rmem_table[_base] == RMEM_NULL)
+	if (nanvix_vmem_translate(_base) == RMEM_NULL)
 		return (-EFAULT);
 
 	_offset = ((raddr_t) ptr) & (RMEM_BLOCK_SIZE - 1);
@@ -101,104 +414,196 @@ static int nanvix_vmem_lookup(raddr_t *base, raddr_t *offset, const void *ptr)
 }
 
 /*============================================================================*
- * nanvix_vmem_expand()                                                       *
+ * nanvix_vmem_release()                                                      *
  *============================================================================*/
 
 /**
- * @brief Increases the break value of the remote memory.
+ * @brief Releases the pages of a region.
  *
- * @param n Number of block to expand.
+ * @param base   First page of the region.
+ * @param npages Number of pages in the region.
  *
- * @returns Upon successful completion, the previous break value of the
- * remote memory is returned. Upon failure, a negative error code is
- * returned instead.
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
  */
-static int nanvix_vmem_expand(int n)
+static int nanvix_vmem_release(int base, int npages)
 {
-	int old_rbrk;
+	int err;
+	rpage_t pgnum;
 
-	/* Invalid heap increase. */
-	if (n <= 0)
-		return (-EINVAL);
+	for (int i = base; i < (base + npages); i++)
+	{
+		/* Not mapped. */
+		if ((pgnum = nanvix_vmem_translate(i)) == RMEM_NULL)
+			continue;
 
-	/* Not enough memory.*/
-	if ((rbrk + n) >= RMEM_TABLE_LENGTH)
+		/* Free underlying remote page. */
+		if (pgnum != RMEM_VMEM_RESERVED)
+		{
+			if ((err = nanvix_rcache_free(pgnum)) < 0)
+				return (err);
+		}
+
+		/* Update remote memory table. */
+		nanvix_vmem_unmap(i);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_vmem_populate()                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Backs a reserved cache line with remote memory.
+ *
+ * @param line First page of the target line.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int nanvix_vmem_populate(int line)
+{
+	rpage_t pgnum;
+
+	/* Allocate line. */
+	if ((pgnum = nanvix_rcache_alloc_line()) == RMEM_NULL)
 		return (-ENOMEM);
 
-	/* Increase heap value. */
-	old_rbrk = rbrk;
-	rbrk += n;
+	/* Entries are already in place, so this does not fail. */
+	for (int j = 0; j < RMEM_CACHE_BLOCK_SIZE; j++)
+		uassert(nanvix_vmem_map(line + j, pgnum + j) == 0);
 
-	return (old_rbrk);
+	return (0);
 }
 
 /*============================================================================*
- * nanvix_vmem_contract()                                                     *
+ * nanvix_vmem_touch()                                                        *
  *============================================================================*/
 
 /**
- * @brief Decreases the break value of the remote memory.
+ * @brief Translates a page, backing it with remote memory if needed.
  *
- * @param n Number of block to contract.
+ * @param page Target page.
  *
- * @returns Upon successful completion, the previous break value of the
- * remote memory is returned. Upon failure, a negative error code is
- * returned instead.
+ * @returns The number of the remote page that backs @p page is
+ * returned. Upon failure, @p RMEM_NULL is returned instead.
  */
-static int nanvix_vmem_contract(int n)
+static rpage_t nanvix_vmem_touch(raddr_t page)
 {
-	int old_rbrk;
+	int idx;
+	int line;
+	rpage_t pgnum;
 
-	/* Invalid heap decrease. */
-	if (n <= 0)
-		return (-EINVAL);
+	/* Already backed. */
+	if ((pgnum = nanvix_vmem_translate(page)) != RMEM_VMEM_RESERVED)
+		return (pgnum);
 
-	/* Bad heap decrease. */
-	if ((rbrk - n) < 1)
-		return (-EINVAL);
+	uassert((idx = nanvix_vmem_region_search(page)) >= 0);
+
+	/* Lines are aligned to the start of the region. */
+	line = rmem_regions.regions[idx].base;
+	line += ((page - line)/RMEM_CACHE_BLOCK_SIZE)*RMEM_CACHE_BLOCK_SIZE;
 
-	/* Increase heap value. */
-	old_rbrk = rbrk;
-	rbrk -= n;
+	if (nanvix_vmem_populate(line) < 0)
+		return (RMEM_NULL);
 
-	return (old_rbrk);
+	return (nanvix_vmem_translate(page));
 }
 
 /*============================================================================*
- * nanvix_vmem_alloc()                                                        *
+ * nanvix_vmem_do_alloc()                                                     *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
- * @todo TODO: Enable arbitrary remote memory allocation.
+ * @brief Allocates remote memory.
+ *
+ * @param n    Number of pages to allocate.
+ * @param lazy Defer allocation of remote memory to first touch?
+ *
+ * @returns Upon successful completion, a pointer to the newly
+ * allocated remote memory area is returned. Upon failure, a null
+ * pointer is returned instead.
  */
-void *nanvix_vmem_alloc(size_t n)
+static void *nanvix_vmem_do_alloc(size_t n, int lazy)
 {
 	int base;
-	rpage_t pgnum;
+	int idx;
+	int npages;
 
 	/* Invalid allocation size */
-	if (n == 0)
+	if ((n == 0) || (n >= RMEM_VMEM_LENGTH))
 		return (NULL);
 
 	/*
-	 * Find an empty slot in the
-	 * remote memory table.
+	 * Allocate whole cache lines, so that
+	 * each line is backed by a single run.
 	 */
-	if ((base = nanvix_vmem_expand(n)) < 0)
+	npages = ((n + (RMEM_CACHE_BLOCK_SIZE - 1))/RMEM_CACHE_BLOCK_SIZE)*RMEM_CACHE_BLOCK_SIZE;
+
+	/*
+	 * Find a hole in the remote
+	 * memory address space.
+	 */
+	if ((base = nanvix_vmem_region_alloc(npages, n)) < 0)
 		return (NULL);
 
-	for (size_t i = 0; i < n; i++)
+	/* Reserve pages. */
+	for (int i = 0; i < npages; i++)
 	{
-		/* Allocate page. */
-		if ((pgnum = nanvix_rcache_alloc()) == RMEM_NULL)
-			return (NULL);
-
-		rmem_table[base + i] = pgnum;
+		if (nanvix_vmem_map(base + i, RMEM_VMEM_RESERVED) < 0)
+			goto error;
 	}
 
+	/* Back pages with remote memory. */
+	if (!lazy)
+	{
+		for (int i = 0; i < npages; i += RMEM_CACHE_BLOCK_SIZE)
+		{
+			if (nanvix_vmem_populate(base + i) < 0)
+				goto error;
+		}
+	}
 
 	return ((void *) RADDR(base));
+
+error:
+	idx = nanvix_vmem_region_search(base);
+	nanvix_vmem_release(base, npages);
+	nanvix_vmem_region_free(idx);
+	return (NULL);
+}
+
+/*============================================================================*
+ * nanvix_vmem_alloc()                                                        *
+ *============================================================================*/
+
+/**
+ * The nanvix_vmem_alloc() function allocates a region of @p n pages
+ * in the remote memory address space. The region is placed in the
+ * first hole that fits it, and it is backed by whole cache lines of
+ * remote memory.
+ */
+void *nanvix_vmem_alloc(size_t n)
+{
+	return (nanvix_vmem_do_alloc(n, 0));
+}
+
+/*============================================================================*
+ * nanvix_vmem_reserve()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_vmem_reserve() function reserves a region of @p n pages
+ * in the remote memory address space, but it does not allocate remote
+ * memory for it. Each cache line of the region is allocated when one
+ * of its pages is first written or faulted in. Reading a page that was
+ * never touched yields zeros and causes no traffic.
+ */
+void *nanvix_vmem_reserve(size_t n)
+{
+	return (nanvix_vmem_do_alloc(n, 1));
 }
 
 /*============================================================================*
@@ -206,12 +611,15 @@ void *nanvix_vmem_alloc(size_t n)
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
+ * The nanvix_vmem_free() function releases the region that starts at
+ * @p ptr. Other regions are left untouched, so regions may be released
+ * in any order.
  */
 int nanvix_vmem_free(void *ptr)
 {
-	int err;      /* Error code.   */
-	raddr_t base; /* Base address. */
+	int err;      /* Error code.    */
+	int idx;      /* Region index.  */
+	raddr_t base; /* Base address.  */
 
 	ptr = (void *)RADDR_INV(ptr);
 
@@ -223,60 +631,244 @@ int nanvix_vmem_free(void *ptr)
 	if ((err = nanvix_vmem_lookup(&base, NULL, ptr)) < 0)
 		return (err);
 
-	/* Invalid address. */
-	if ((rbrk - base) < 1)
+	/* Not the start of a region. */
+	if (((raddr_t) ptr & (RMEM_BLOCK_SIZE - 1)) != 0)
+		return (-EFAULT);
+	if ((idx = nanvix_vmem_region_search(base)) < 0)
+		return (-EFAULT);
+	if (rmem_regions.regions[idx].base != (int) base)
 		return (-EFAULT);
 
-	for (int i = base; i < rbrk; i++)
-	{
-		/* Free underlying remote page. */
-		if ((err = nanvix_rcache_free(rmem_table[i])) < 0)
-			return (err);
-
-		/* Update remote memory table. */
-		rmem_table[i] = RMEM_NULL;
-	}
+	if ((err = nanvix_vmem_release(base, rmem_regions.regions[idx].npages)) < 0)
+		return (err);
 
-	err = nanvix_vmem_contract(rbrk - base);
+	nanvix_vmem_region_free(idx);
 
-	return ((err < 0) ? err : 0);
+	return (0);
 }
 
 /*============================================================================*
- * nanvix_vmem_read()                                                         *
+ * nanvix_vmem_check()                                                        *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
- * @todo TODO: Enable arbitrary read offset.
- * @todo TODO: Enable arbitrary read sizes.
+ * @brief Asserts that a range of remote memory lies in a region.
+ *
+ * @param ptr Start of the target range.
+ * @param n   Length of the target range (in bytes).
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
  */
-size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
+static int nanvix_vmem_check(const void *ptr, size_t n)
 {
-	char *rptr;     /* Cached remote page. */
-	int err;        /* Error code.         */
-	raddr_t base;   /* Base address.       */
-	raddr_t offset; /* Offset address.     */
+	int idx;
+	raddr_t first;
+	raddr_t last;
 
-	ptr = (void *)RADDR_INV(ptr);
+	first = ((raddr_t) ptr) >> RMEM_BLOCK_SHIFT;
+	last = (((raddr_t) ptr) + n - 1) >> RMEM_BLOCK_SHIFT;
 
-	/* Nothing to do. */
-	if (n == 0)
-		return (0);
+	/* Invalid remote memory area. */
+	if ((last < first) || (last >= RMEM_VMEM_LENGTH))
+		return (-EINVAL);
 
-	/* Invalid remote address. */
-	if (ptr == NULL)
-	{
-		errno = EFAULT;
-		return (0);
-	}
+	/* Bad remote memory address. */
+	if ((idx = nanvix_vmem_region_search(first)) < 0)
+		return (-EFAULT);
+	if (first >= (raddr_t)(rmem_regions.regions[idx].base + rmem_regions.regions[idx].length))
+		return (-EFAULT);
 
-	/* Lookup remote address. */
-	if ((err = nanvix_vmem_lookup(&base, &offset, ptr)) < 0)
-	{
-		errno = -err;
-		return (0);
-	}
+	/* Range crosses the end of the region. */
+	if (last >= (raddr_t)(rmem_regions.regions[idx].base + rmem_regions.regions[idx].length))
+		return (-EINVAL);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_vmem_run()                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Measures a run of remote pages.
+ *
+ * @param base   First page of the target range.
+ * @param npages Maximum number of pages.
+ *
+ * @returns The number of pages, starting at @p base, that are backed
+ * by consecutive remote pages of the same server.
+ */
+static int nanvix_vmem_run(raddr_t base, int npages)
+{
+	int i;
+	rpage_t pgnum;
+
+	pgnum = nanvix_vmem_translate(base);
+
+	for (i = 1; i < npages; i++)
+	{
+		/* Different server. */
+		if ((RMEM_BLOCK_NUM(pgnum) + i) >= RMEM_NUM_BLOCKS)
+			break;
+
+		if (nanvix_vmem_translate(base + i) != (pgnum + i))
+			break;
+	}
+
+	return (i);
+}
+
+/*============================================================================*
+ * nanvix_vmem_fill()                                                         *
+ *============================================================================*/
+
+/**
+ * @brief Maximum number of pages loaded at once.
+ *
+ * Loaded pages should still be cached when they are copied.
+ */
+#define RMEM_VMEM_FILL_MAX (RMEM_CACHE_LENGTH/2)
+
+/**
+ * @brief Loads a range of remote pages into the page cache.
+ *
+ * @param first First page of the target range.
+ * @param last  Last page of the target range.
+ *
+ * @returns The page that follows the last one that was loaded.
+ *
+ * @note At most RMEM_VMEM_FILL_MAX pages are loaded, with requests
+ * to different servers overlapped. Pages that were never touched are
+ * skipped. Errors are ignored, as pages that could not be loaded are
+ * fetched again when they are copied.
+ */
+static raddr_t nanvix_vmem_fill(raddr_t first, raddr_t last)
+{
+	int n = 0;
+	raddr_t page;
+	rpage_t pgnum;
+	rpage_t pgnums[RMEM_VMEM_FILL_MAX];
+
+	for (page = first; (page <= last) && (n < RMEM_VMEM_FILL_MAX); page++)
+	{
+		pgnum = nanvix_vmem_translate(page);
+
+		/* Untouched page. */
+		if ((pgnum == RMEM_NULL) || (pgnum == RMEM_VMEM_RESERVED))
+			continue;
+
+		pgnums[n++] = pgnum;
+	}
+
+	/* Bypass mode: nowhere to keep pages. */
+	if (nanvix_rcache_fetchv(pgnums, n) == -ENOTSUP)
+		return (last + 1);
+
+	return (page);
+}
+
+/**
+ * @brief Loads the pages that a vector of writes covers partially.
+ *
+ * @param addr   Remote address of the first write.
+ * @param iov    Writes.
+ * @param iovcnt Number of writes in @p iov.
+ *
+ * @returns The number of writes whose pages were loaded.
+ *
+ * @note Writes are contiguous, thus only pages that hold the edges
+ * of a write are written partially. Other pages are installed in the
+ * page cache without being fetched.
+ */
+static int nanvix_vmem_fill_edges(raddr_t addr, const struct rmem_iovec *iov, int iovcnt)
+{
+	int i;
+	int n = 0;
+	raddr_t page;
+	raddr_t prev = RMEM_VMEM_LENGTH;
+	rpage_t pgnum;
+	rpage_t pgnums[RMEM_VMEM_FILL_MAX];
+
+	for (i = 0; (i < iovcnt) && (n <= (RMEM_VMEM_FILL_MAX - 2)); i++)
+	{
+		raddr_t edges[2] = { addr, addr + iov[i].iov_len };
+
+		for (int j = 0; j < 2; j++)
+		{
+			/* Page is not written partially. */
+			if ((edges[j] & (RMEM_BLOCK_SIZE - 1)) == 0)
+				continue;
+
+			/* Page is loaded already. */
+			if ((page = edges[j] >> RMEM_BLOCK_SHIFT) == prev)
+				continue;
+
+			prev = page;
+			pgnum = nanvix_vmem_translate(page);
+
+			/* Untouched page. */
+			if ((pgnum == RMEM_NULL) || (pgnum == RMEM_VMEM_RESERVED))
+				continue;
+
+			pgnums[n++] = pgnum;
+		}
+
+		addr += iov[i].iov_len;
+	}
+
+	nanvix_rcache_fetchv(pgnums, n);
+
+	return (i);
+}
+
+/*============================================================================*
+ * nanvix_vmem_read()                                                         *
+ *============================================================================*/
+
+/**
+ * @brief Reads data from remote memory.
+ *
+ * @param buf    Target local buffer.
+ * @param ptr    Source remote memory area.
+ * @param n      Number of bytes to read.
+ * @param ahead  Number of bytes that may be loaded ahead (at least @p n).
+ * @param filled Page that follows the last one loaded in the cache.
+ *
+ * @returns The number of bytes read.
+ */
+static size_t nanvix_vmem_do_read(void *buf, const void *ptr, size_t n, size_t ahead, raddr_t *filled)
+{
+	char *rptr;     /* Cached remote page. */
+	int err;        /* Error code.         */
+	int npages;     /* Pages in a run.     */
+	int noreuse;    /* Stream pages?       */
+	rpage_t pgnum;  /* Remote page.        */
+	size_t len;     /* Transfer length.    */
+	size_t total;   /* Bytes read.         */
+	raddr_t base;   /* Base address.       */
+	raddr_t offset; /* Offset address.     */
+	raddr_t last;   /* Last page.          */
+
+	ptr = (void *)RADDR_INV(ptr);
+
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+
+	/* Invalid remote address. */
+	if (ptr == NULL)
+	{
+		errno = EFAULT;
+		return (0);
+	}
+
+	/* Lookup remote address. */
+	if ((err = nanvix_vmem_lookup(&base, &offset, ptr)) < 0)
+	{
+		errno = -err;
+		return (0);
+	}
 
 	/* Invalid buffer. */
 	if (buf == NULL)
@@ -286,36 +878,112 @@ size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
 	}
 
 	/* Invalid read size. */
-	if ((n > RMEM_BLOCK_SIZE) || ((offset + n) > RMEM_BLOCK_SIZE))
+	if ((err = nanvix_vmem_check(ptr, n)) < 0)
 	{
-		errno = EINVAL;
+		errno = -err;
 		return (0);
 	}
 
-	/* Get cached remote page. */
-	if ((rptr = nanvix_rcache_get(rmem_table[base])) == NULL)
-		return (0);
+	noreuse = (nanvix_vmem_advice(base) == RMEM_ADVICE_NOREUSE);
+	last = (((raddr_t) ptr) + ahead - 1) >> RMEM_BLOCK_SHIFT;
+
+	for (total = 0; total < n; total += len)
+	{
+		uassert(nanvix_vmem_lookup(&base, &offset, (const char *) ptr + total) == 0);
+
+		/* Load the next pages with batched requests. */
+		if (!noreuse && (base >= *filled))
+			*filled = nanvix_vmem_fill(base, last);
+
+		/* Untouched page. */
+		if ((pgnum = nanvix_vmem_translate(base)) == RMEM_VMEM_RESERVED)
+		{
+			len = RMEM_BLOCK_SIZE - offset;
+			if (len > (n - total))
+				len = n - total;
+
+			umemset((char *) buf + total, 0, len);
+			continue;
+		}
+
+		/* Transfer whole pages straight into user buffer. */
+		if ((offset == 0) && ((n - total) >= RMEM_BLOCK_SIZE))
+		{
+			npages = (n - total) >> RMEM_BLOCK_SHIFT;
+			npages = nanvix_vmem_run(base, (npages < RMEM_RUN_MAX) ? npages : RMEM_RUN_MAX);
+			len = npages*RMEM_BLOCK_SIZE;
+
+			err = (noreuse) ?
+				nanvix_rcache_stream_read(pgnum, (char *) buf + total, npages) :
+				nanvix_rcache_read(pgnum, (char *) buf + total, npages);
+			if (err == 0)
+				continue;
+
+			if (err != -ENOTSUP)
+			{
+				errno = -err;
+				return (total);
+			}
+		}
+
+		len = RMEM_BLOCK_SIZE - offset;
+		if (len > (n - total))
+			len = n - total;
+
+		/* Get cached remote page. */
+		if ((rptr = nanvix_rcache_get(pgnum)) == NULL)
+			return (total);
 
-	umemcpy(buf, &rptr[offset], n);
+		umemcpy((char *) buf + total, &rptr[offset], len);
+	}
 
 	return (n);
 }
 
+/**
+ * The nanvix_vmem_read() function reads @p n bytes from the remote
+ * memory area pointed to by @p ptr into the local buffer pointed to by
+ * @p buf. The area may span several pages, but it should lie within a
+ * single region. In bypass mode, or if no reuse was advised for the
+ * region, whole pages that are backed by consecutive remote pages are
+ * fetched with a single request and without going through the cache.
+ * Otherwise, missing pages are loaded in batches before they are
+ * copied, so that requests to different servers overlap.
+ */
+size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
+{
+	raddr_t filled = 0;
+
+	return (nanvix_vmem_do_read(buf, ptr, n, n, &filled));
+}
+
 /*============================================================================*
  * nanvix_vmem_write()                                                        *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
- * @todo TODO: Enable arbitrary write offset.
- * @todo TODO: Enable arbitrary write sizes.
+ * @brief Writes data to remote memory.
+ *
+ * @param ptr    Target remote memory area.
+ * @param buf    Source local buffer.
+ * @param n      Number of bytes to write.
+ * @param ahead  Number of bytes that may be loaded ahead (at least @p n).
+ * @param filled Page that follows the last one loaded in the cache.
+ *
+ * @returns The number of bytes written.
  */
-size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
+static size_t nanvix_vmem_do_write(void *ptr, const void *buf, size_t n, size_t ahead, raddr_t *filled)
 {
 	char *rptr;     /* Cached remote page. */
 	int err;        /* Error code.         */
+	int npages;     /* Pages in a run.     */
+	int noreuse;    /* Stream pages?       */
+	rpage_t pgnum;  /* Remote page.        */
+	size_t len;     /* Transfer length.    */
+	size_t total;   /* Bytes written.      */
 	raddr_t base;   /* Base address.       */
 	raddr_t offset; /* Offset address.     */
+	raddr_t last;   /* Last page.          */
 
 	ptr = (void *)RADDR_INV(ptr);
 
@@ -345,77 +1013,913 @@ size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
 	}
 
 	/* Invalid write size. */
-	if ((n > RMEM_BLOCK_SIZE) || ((offset + n) > RMEM_BLOCK_SIZE))
+	if ((err = nanvix_vmem_check(ptr, n)) < 0)
 	{
-		errno = EINVAL;
+		errno = -err;
 		return (0);
 	}
 
-	/* Get cached remote page. */
-	if ((rptr = nanvix_rcache_get(rmem_table[base])) == NULL)
-		return (0);
+	noreuse = (nanvix_vmem_advice(base) == RMEM_ADVICE_NOREUSE);
+	last = (((raddr_t) ptr) + ahead - 1) >> RMEM_BLOCK_SHIFT;
+
+	for (total = 0; total < n; total += len)
+	{
+		uassert(nanvix_vmem_lookup(&base, &offset, (char *) ptr + total) == 0);
+
+		/*
+		 * Load the next lines with batched requests. Lines
+		 * that span several pages are fetched even on full-page
+		 * writes, as their other pages are not overwritten.
+		 */
+		if (!noreuse && (RMEM_CACHE_BLOCK_SIZE > 1) && (base >= *filled))
+			*filled = nanvix_vmem_fill(base, last);
+
+		/* Back page with remote memory. */
+		if ((pgnum = nanvix_vmem_touch(base)) == RMEM_NULL)
+		{
+			errno = ENOMEM;
+			return (total);
+		}
+
+		/* Transfer whole pages straight from user buffer. */
+		if ((offset == 0) && ((n - total) >= RMEM_BLOCK_SIZE))
+		{
+			npages = (n - total) >> RMEM_BLOCK_SHIFT;
+			npages = nanvix_vmem_run(base, (npages < RMEM_RUN_MAX) ? npages : RMEM_RUN_MAX);
+			len = npages*RMEM_BLOCK_SIZE;
+
+			err = (noreuse) ?
+				nanvix_rcache_stream_write(pgnum, (const char *) buf + total, npages) :
+				nanvix_rcache_write(pgnum, (const char *) buf + total, npages);
+			if (err == 0)
+				continue;
+
+			if (err != -ENOTSUP)
+			{
+				errno = -err;
+				return (total);
+			}
+		}
+
+		len = RMEM_BLOCK_SIZE - offset;
+		if (len > (n - total))
+			len = n - total;
+
+		/*
+		 * Get cached remote page. Full-page writes
+		 * do not need the old contents of the page.
+		 */
+		if (len == RMEM_BLOCK_SIZE)
+			rptr = nanvix_rcache_install(pgnum);
+		else
+			rptr = nanvix_rcache_get(pgnum);
 
-	umemcpy(&rptr[offset], buf, n);
+		if (rptr == NULL)
+			return (total);
+
+		umemcpy(&rptr[offset], (const char *) buf + total, len);
+	}
 
 	return (n);
 }
 
+/**
+ * The nanvix_vmem_write() function writes @p n bytes from the local
+ * buffer pointed to by @p buf into the remote memory area pointed to
+ * by @p ptr. The area may span several pages, but it should lie within
+ * a single region. In bypass mode, or if no reuse was advised for the
+ * region, whole pages that are backed by consecutive remote pages are
+ * written with a single request and without going through the cache.
+ * Otherwise, pages that are written partially are loaded together
+ * before any data is copied.
+ */
+size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
+{
+	raddr_t filled = 0;
+	struct rmem_iovec iov = { (void *) buf, n };
+
+	if ((ptr != NULL) && (n > 0))
+		nanvix_vmem_fill_edges(RADDR_INV(ptr), &iov, 1);
+
+	return (nanvix_vmem_do_write(ptr, buf, n, n, &filled));
+}
+
 /*============================================================================*
- * nanvix_rfault()                                                            *
+ * nanvix_vmem_readv()                                                        *
  *============================================================================*/
 
 /**
- * @brief Page maps.
+ * The nanvix_vmem_readv() function reads a contiguous remote memory
+ * area that starts at @p ptr and scatters it over the @p iovcnt local
+ * buffers described by @p iov, filling them in order. Missing pages
+ * are loaded in batches that span several buffers.
  */
-static struct
+size_t nanvix_vmem_readv(const void *ptr, const struct rmem_iovec *iov, int iovcnt)
 {
-	vaddr_t laddr; /**< Local address.                         */
-	void *raddr;   /**< Pointer to locally-mapped remote page. */
-} maps[RMEM_CACHE_SIZE] = {
-	[0 ... (RMEM_CACHE_SIZE - 1)] = { RMEM_NULL, NULL }
-};
+	size_t n;
+	size_t span = 0;
+	size_t total = 0;
+	raddr_t filled = 0;
+
+	/* Invalid vector. */
+	if ((iov == NULL) || (iovcnt <= 0))
+	{
+		errno = EINVAL;
+		return (0);
+	}
+
+	for (int i = 0; i < iovcnt; i++)
+		span += iov[i].iov_len;
+
+	for (int i = 0; i < iovcnt; i++)
+	{
+		/* Nothing to do. */
+		if (iov[i].iov_len == 0)
+			continue;
+
+		n = nanvix_vmem_do_read(iov[i].iov_base, (const char *) ptr + total, iov[i].iov_len, span - total, &filled);
+		total += n;
+
+		/* Short read. */
+		if (n != iov[i].iov_len)
+			break;
+	}
+
+	return (total);
+}
+
+/*============================================================================*
+ * nanvix_vmem_writev()                                                       *
+ *============================================================================*/
 
 /**
- * @brief Handles a page fault.
+ * The nanvix_vmem_writev() function gathers the @p iovcnt local
+ * buffers described by @p iov, in order, and writes them to the
+ * contiguous remote memory area that starts at @p ptr. Pages that
+ * are written partially are loaded in batches that span several
+ * buffers.
  */
-int nanvix_rfault(vaddr_t vaddr)
+size_t nanvix_vmem_writev(void *ptr, const struct rmem_iovec *iov, int iovcnt)
 {
-	int idx = 0;  /* Idex to table of page maps.  */
-	void *lptr;   /* Local pointer.               */
-	void *rptr;   /* Remote pointer.              */
-	raddr_t base; /* Base address of remote page. */
+	size_t n;
+	size_t span = 0;
+	size_t total = 0;
+	raddr_t filled = 0;
+	int edges = 0;
+
+	/* Invalid vector. */
+	if ((iov == NULL) || (iovcnt <= 0))
+	{
+		errno = EINVAL;
+		return (0);
+	}
 
-	vaddr &= PAGE_MASK;
-	lptr = (void *)RADDR_INV(vaddr);
+	for (int i = 0; i < iovcnt; i++)
+		span += iov[i].iov_len;
 
-	/* Lookup remote address. */
-	if (nanvix_vmem_lookup(&base, NULL, lptr) < 0)
-		return (-EFAULT);
+	for (int i = 0; i < iovcnt; i++)
+	{
+		/* Nothing to do. */
+		if (iov[i].iov_len == 0)
+			continue;
 
-	/* Get cached remote page. */
-	if ((rptr = nanvix_rcache_get(rmem_table[base])) == NULL)
-		return (-EFAULT);
+		/* Load pages of the next buffers. */
+		if ((ptr != NULL) && (i >= edges))
+			edges = i + nanvix_vmem_fill_edges(RADDR_INV((char *) ptr + total), &iov[i], iovcnt - i);
 
-	/* Unlink old page page from there. */
-	for (int i = 0; i < RMEM_CACHE_SIZE; i++)
+		n = nanvix_vmem_do_write((char *) ptr + total, iov[i].iov_base, iov[i].iov_len, span - total, &filled);
+		total += n;
+
+		/* Short write. */
+		if (n != iov[i].iov_len)
+			break;
+	}
+
+	return (total);
+}
+
+/*============================================================================*
+ * nanvix_vmem_advise()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Maximum number of pages prefetched at once.
+ */
+#define RMEM_ADVICE_PREFETCH_MAX (RMEM_CACHE_SIZE/2)
+
+/**
+ * @brief Asserts that every page of a range lies in some region.
+ *
+ * @param first First page of the target range.
+ * @param last  Last page of the target range.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int nanvix_vmem_check_span(raddr_t first, raddr_t last)
+{
+	int idx;
+	raddr_t end;
+
+	/* Invalid remote memory area. */
+	if ((last < first) || (last >= RMEM_VMEM_LENGTH))
+		return (-EINVAL);
+
+	for (raddr_t page = first; page <= last; page = end)
 	{
-		/* Found. */
-		if (maps[i].raddr == rptr)
+		if ((idx = nanvix_vmem_region_search(page)) < 0)
+			return (-EFAULT);
+
+		end = rmem_regions.regions[idx].base + rmem_regions.regions[idx].length;
+		if (page >= end)
+			return (-EFAULT);
+	}
+
+	return (0);
+}
+
+/**
+ * @brief Drops a range of remote memory.
+ *
+ * @param first First page of the target range.
+ * @param last  Last page of the target range.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ *
+ * @note The target range may span adjacent regions.
+ */
+static int nanvix_vmem_dontneed(raddr_t first, raddr_t last)
+{
+	int err;
+	int idx;
+	raddr_t end;
+	raddr_t line;
+	rpage_t pgnum;
+
+	/* Every page must lie in some region. */
+	if ((err = nanvix_vmem_check_span(first, last)) < 0)
+		return (err);
+
+	idx = nanvix_vmem_region_search(first);
+	end = rmem_regions.regions[idx].base + rmem_regions.regions[idx].length;
+
+	for (raddr_t page = first; page <= last; page++)
+	{
+		/* Move on to the next region. */
+		if (page >= end)
 		{
-			uassert(page_unmap(maps[idx = i].laddr) == 0);
-			goto done;
+			idx = nanvix_vmem_region_search(page);
+			end = rmem_regions.regions[idx].base + rmem_regions.regions[idx].length;
 		}
 
-		/* Remember this index. */
-		idx = i;
-	}
+		if ((pgnum = nanvix_vmem_translate(page)) == RMEM_VMEM_RESERVED)
+			continue;
 
-done:
+		/* Lines are aligned to the start of the region. */
+		line = rmem_regions.regions[idx].base;
+		line += ((page - line)/RMEM_CACHE_BLOCK_SIZE)*RMEM_CACHE_BLOCK_SIZE;
 
-	/* Link page. */
-	maps[idx].raddr = rptr;
-	maps[idx].laddr = vaddr;
-	uassert(page_link((vaddr_t) rptr, (vaddr_t) vaddr) == 0);
+		/* Partially covered line: keep its contents. */
+		if ((line < first) || ((line + RMEM_CACHE_BLOCK_SIZE - 1) > last))
+		{
+			if ((err = nanvix_rcache_evict(pgnum)) < 0)
+				return (err);
+			continue;
+		}
+
+		/* Give remote page back, and read it as zeros from now on. */
+		if ((err = nanvix_rcache_free(pgnum)) < 0)
+			return (err);
+		uassert(nanvix_vmem_map(page, RMEM_VMEM_RESERVED) == 0);
+	}
 
 	return (0);
 }
+
+/**
+ * The nanvix_vmem_advise() function advises the remote memory manager
+ * on how the @p len bytes of remote memory that start at @p ptr are
+ * going to be accessed.
+ *
+ * - RMEM_ADVICE_NORMAL: default behaviour.
+ * - RMEM_ADVICE_SEQUENTIAL: page faults read ahead following pages.
+ * - RMEM_ADVICE_RANDOM: page faults map only the faulting page.
+ * - RMEM_ADVICE_WILLNEED: pages are prefetched into the cache now.
+ * - RMEM_ADVICE_DONTNEED: pages are evicted from the cache, and lines
+ *   that are fully covered are given back to remote memory. They read
+ *   as zeros afterwards. The range may span adjacent regions.
+ * - RMEM_ADVICE_NOREUSE: whole-page reads and writes skip the cache.
+ *
+ * Access patterns (NORMAL, SEQUENTIAL, RANDOM and NOREUSE) apply to
+ * the whole region that contains @p ptr.
+ */
+int nanvix_vmem_advise(void *ptr, size_t len, int advice)
+{
+	int err;
+	int idx;
+	raddr_t first;
+	raddr_t last;
+	rpage_t pgnum;
+
+	ptr = (void *)RADDR_INV(ptr);
+
+	/* Invalid remote address. */
+	if (ptr == NULL)
+		return (-EFAULT);
+
+	/* Bad alignment. */
+	if (((raddr_t) ptr & (RMEM_BLOCK_SIZE - 1)) != 0)
+		return (-EINVAL);
+
+	/* Nothing to do. */
+	if (len == 0)
+		return (0);
+
+	first = ((raddr_t) ptr) >> RMEM_BLOCK_SHIFT;
+	last = (((raddr_t) ptr) + len - 1) >> RMEM_BLOCK_SHIFT;
+
+	if (advice == RMEM_ADVICE_DONTNEED)
+		return (nanvix_vmem_dontneed(first, last));
+
+	/* Bad range. */
+	if ((err = nanvix_vmem_check(ptr, len)) < 0)
+		return (err);
+
+	idx = nanvix_vmem_region_search(first);
+
+	switch (advice)
+	{
+		case RMEM_ADVICE_NORMAL:
+		case RMEM_ADVICE_SEQUENTIAL:
+		case RMEM_ADVICE_RANDOM:
+		case RMEM_ADVICE_NOREUSE:
+			rmem_regions.regions[idx].advice = advice;
+			break;
+
+		case RMEM_ADVICE_WILLNEED:
+			for (raddr_t page = first; (page <= last) && ((page - first) < RMEM_ADVICE_PREFETCH_MAX); page++)
+			{
+				if ((pgnum = nanvix_vmem_translate(page)) == RMEM_VMEM_RESERVED)
+					continue;
+
+				/* Bypass mode: nowhere to keep pages. */
+				if ((err = nanvix_rcache_prefetch(pgnum)) == -ENOTSUP)
+					break;
+				if (err < 0)
+					return (err);
+			}
+			break;
+
+		default:
+			return (-EINVAL);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_vmem_zero()                                                         *
+ *============================================================================*/
+
+/**
+ * The nanvix_vmem_zero() function fills the @p n bytes of remote
+ * memory that start at @p ptr with zeros. Pages that were never
+ * touched already read as zeros and are left alone, and lines that
+ * are fully covered are given back to remote memory rather than
+ * written. The area may span adjacent regions.
+ */
+int nanvix_vmem_zero(void *ptr, size_t n)
+{
+	int err;        /* Error code.             */
+	char *rptr;     /* Cached remote page.     */
+	size_t len;     /* Bytes in current page.  */
+	raddr_t addr;   /* Current address.        */
+	raddr_t end;    /* End address.            */
+	raddr_t first;  /* First whole page.       */
+	raddr_t last;   /* Past last whole page.   */
+	rpage_t pgnum;  /* Remote page.            */
+
+	ptr = (void *)RADDR_INV(ptr);
+
+	/* Invalid remote address. */
+	if (ptr == NULL)
+		return (-EFAULT);
+
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+
+	addr = (raddr_t) ptr;
+	end = addr + n;
+
+	/* Bad range. */
+	if ((err = nanvix_vmem_check_span(addr >> RMEM_BLOCK_SHIFT, (end - 1) >> RMEM_BLOCK_SHIFT)) < 0)
+		return (err);
+
+	/* Give back whole pages. */
+	first = TRUNCATE(addr, RMEM_BLOCK_SIZE) >> RMEM_BLOCK_SHIFT;
+	last = end >> RMEM_BLOCK_SHIFT;
+	if ((first < last) && ((err = nanvix_vmem_dontneed(first, last - 1)) < 0))
+		return (err);
+
+	/* Write zeros to whatever is still backed. */
+	for (/* noop */; addr < end; addr += len)
+	{
+		len = RMEM_BLOCK_SIZE - (addr & (RMEM_BLOCK_SIZE - 1));
+		if (len > (end - addr))
+			len = end - addr;
+
+		/* Reads as zeros. */
+		if ((pgnum = nanvix_vmem_translate(addr >> RMEM_BLOCK_SHIFT)) == RMEM_VMEM_RESERVED)
+			continue;
+
+		rptr = (len == RMEM_BLOCK_SIZE) ?
+			nanvix_rcache_install(pgnum) : nanvix_rcache_get(pgnum);
+
+		if (rptr == NULL)
+			return (-EFAULT);
+
+		umemset(&rptr[addr & (RMEM_BLOCK_SIZE - 1)], 0, len);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * Page Maps                                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of pages mapped on a fault (fault-around window).
+ */
+#ifndef __RMEM_FAULT_AROUND
+#define RMEM_FAULT_AROUND 4
+#else
+#define RMEM_FAULT_AROUND __RMEM_FAULT_AROUND
+#endif
+
+/**
+ * @brief Number of buckets in the table of page maps.
+ */
+#define RMEM_MAPS_BUCKETS RMEM_CACHE_SIZE
+
+/**
+ * @brief Hashes a locally-mapped remote page.
+ */
+#define RMEM_MAPS_HASH(x) ((((vaddr_t)(x)) >> RMEM_BLOCK_SHIFT) % RMEM_MAPS_BUCKETS)
+
+/**
+ * @brief Page maps.
+ *
+ * Each cached remote page is linked to at most one local address, so
+ * maps are hashed by the cached page. Maps are dropped as soon as the
+ * page leaves the cache.
+ */
+static struct
+{
+	vaddr_t laddr; /**< Local address.                         */
+	void *raddr;   /**< Pointer to locally-mapped remote page. */
+	int next;      /**< Next map in the same bucket.           */
+} maps[RMEM_CACHE_SIZE];
+
+/**
+ * @brief Buckets of the table of page maps.
+ */
+static int maps_buckets[RMEM_MAPS_BUCKETS] = {
+	[0 ... (RMEM_MAPS_BUCKETS - 1)] = -1
+};
+
+/**
+ * @brief List of free page maps.
+ */
+static int maps_free = -1;
+
+/**
+ * @brief Is the table of page maps initialized?
+ */
+static int maps_initialized = 0;
+
+/**
+ * @brief Searches for the map of a cached remote page.
+ *
+ * @param rptr Target cached remote page.
+ *
+ * @returns If @p rptr is mapped, the index of its map is returned.
+ * Otherwise, -1 is returned instead.
+ */
+static int nanvix_maps_search(const void *rptr)
+{
+	for (int i = maps_buckets[RMEM_MAPS_HASH(rptr)]; i >= 0; i = maps[i].next)
+	{
+		if (maps[i].raddr == rptr)
+			return (i);
+	}
+
+	return (-1);
+}
+
+/**
+ * @brief Unlinks a cached remote page.
+ *
+ * @param rptr Target cached remote page.
+ */
+static void nanvix_maps_unlink(const void *rptr)
+{
+	int *prev;
+
+	for (prev = &maps_buckets[RMEM_MAPS_HASH(rptr)]; *prev >= 0; prev = &maps[*prev].next)
+	{
+		int i = *prev;
+
+		if (maps[i].raddr != rptr)
+			continue;
+
+		uassert(page_unmap(maps[i].laddr) == 0);
+
+		*prev = maps[i].next;
+		maps[i].raddr = NULL;
+		maps[i].laddr = 0;
+		maps[i].next = maps_free;
+		maps_free = i;
+
+		return;
+	}
+}
+
+/**
+ * @brief Links a cached remote page to a local address.
+ *
+ * @param rptr  Target cached remote page.
+ * @param vaddr Target local address.
+ */
+static void nanvix_maps_link(void *rptr, vaddr_t vaddr)
+{
+	int i;
+
+	/* Unlink old page from there. */
+	nanvix_maps_unlink(rptr);
+
+	uassert((i = maps_free) >= 0);
+	maps_free = maps[i].next;
+
+	maps[i].raddr = rptr;
+	maps[i].laddr = vaddr;
+	maps[i].next = maps_buckets[RMEM_MAPS_HASH(rptr)];
+	maps_buckets[RMEM_MAPS_HASH(rptr)] = i;
+
+	uassert(page_link((vaddr_t) rptr, vaddr) == 0);
+}
+
+/**
+ * @brief Handles the eviction of a cached remote page.
+ *
+ * @param pgnum Number of the evicted page.
+ * @param page  Cached remote page.
+ */
+static void nanvix_maps_evict(rpage_t pgnum, void *page)
+{
+	UNUSED(pgnum);
+
+	nanvix_maps_unlink(page);
+}
+
+/**
+ * @brief Initializes the table of page maps.
+ */
+static void nanvix_maps_init(void)
+{
+	for (int i = 0; i < RMEM_CACHE_SIZE; i++)
+	{
+		maps[i].raddr = NULL;
+		maps[i].laddr = 0;
+		maps[i].next = (i + 1 < RMEM_CACHE_SIZE) ? (i + 1) : -1;
+	}
+	maps_free = 0;
+
+	nanvix_rcache_evict_handler(nanvix_maps_evict);
+
+	maps_initialized = 1;
+}
+
+/*============================================================================*
+ * nanvix_vmem_remap()                                                        *
+ *============================================================================*/
+
+/**
+ * @brief Asserts that a page starts a cache line.
+ *
+ * @param page Target page.
+ *
+ * @returns Non-zero if @p page starts a cache line, and zero otherwise.
+ */
+static int nanvix_vmem_line_aligned(raddr_t page)
+{
+	int idx;
+
+	uassert((idx = nanvix_vmem_region_search(page)) >= 0);
+
+	/* Lines are aligned to the start of the region. */
+	return (((page - rmem_regions.regions[idx].base) % RMEM_CACHE_BLOCK_SIZE) == 0);
+}
+
+/**
+ * The nanvix_vmem_remap() function moves the remote pages that back
+ * the @p n bytes at @p src over to @p dst, without copying any data.
+ * Remote pages that backed @p dst are freed, and pages at @p src read
+ * as zeros afterwards. Both areas must start cache lines and span
+ * whole lines.
+ */
+int nanvix_vmem_remap(void *dst, const void *src, size_t n)
+{
+	int err;
+	void *rptr;
+	raddr_t to;
+	raddr_t from;
+	raddr_t npages;
+	rpage_t pgnum;
+
+	dst = (void *)RADDR_INV(dst);
+	src = (const void *)RADDR_INV(src);
+
+	/* Invalid remote address. */
+	if ((dst == NULL) || (src == NULL))
+		return (-EFAULT);
+
+	/* Bad alignment. */
+	if ((((raddr_t) dst | (raddr_t) src | n) & (RMEM_BLOCK_SIZE - 1)) != 0)
+		return (-EINVAL);
+
+	/* Nothing to do. */
+	if (n == 0)
+		return (0);
+
+	/* Bad range. */
+	if ((err = nanvix_vmem_check(dst, n)) < 0)
+		return (err);
+	if ((err = nanvix_vmem_check(src, n)) < 0)
+		return (err);
+
+	to = ((raddr_t) dst) >> RMEM_BLOCK_SHIFT;
+	from = ((raddr_t) src) >> RMEM_BLOCK_SHIFT;
+	npages = n >> RMEM_BLOCK_SHIFT;
+
+	/* Overlapping areas. */
+	if ((to < (from + npages)) && (from < (to + npages)))
+		return (-EINVAL);
+
+	/* Lines are moved as a whole. */
+	if ((npages % RMEM_CACHE_BLOCK_SIZE) != 0)
+		return (-EINVAL);
+	if (!nanvix_vmem_line_aligned(to) || !nanvix_vmem_line_aligned(from))
+		return (-EINVAL);
+
+	for (raddr_t i = 0; i < npages; i++)
+	{
+		/* Give back remote page that backs the destination. */
+		if ((pgnum = nanvix_vmem_translate(to + i)) != RMEM_VMEM_RESERVED)
+		{
+			if ((err = nanvix_rcache_free(pgnum)) < 0)
+				return (err);
+		}
+
+		pgnum = nanvix_vmem_translate(from + i);
+
+		/* Drop stale local mapping. */
+		if (pgnum != RMEM_VMEM_RESERVED)
+		{
+			if ((rptr = nanvix_rcache_peek(pgnum)) != NULL)
+				nanvix_maps_unlink(rptr);
+		}
+
+		/* Entries are already in place, so this does not fail. */
+		uassert(nanvix_vmem_map(to + i, pgnum) == 0);
+		uassert(nanvix_vmem_map(from + i, RMEM_VMEM_RESERVED) == 0);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rfault_window()                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Sizes the fault-around window of a page.
+ *
+ * @param base      Target page.
+ * @param readahead Store location for the read-ahead flag.
+ *
+ * @returns The number of pages in the fault-around window.
+ */
+static int nanvix_rfault_window(raddr_t base, int *readahead)
+{
+	switch (nanvix_vmem_advice(base))
+	{
+		case RMEM_ADVICE_RANDOM:
+			*readahead = 0;
+			return (1);
+
+		case RMEM_ADVICE_SEQUENTIAL:
+			*readahead = 1;
+			return (RMEM_FAULT_READAHEAD);
+
+		default:
+			*readahead = 0;
+			return (RMEM_FAULT_AROUND);
+	}
+}
+
+/*============================================================================*
+ * nanvix_rfault_claim()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rfault_claim() function starts handling a fault on the
+ * local address @p vaddr. The faulting page is backed with remote
+ * memory, and cache lines are claimed for it and, in sequential
+ * regions, for the pages to read ahead. Pages that are already cached
+ * need no line.
+ */
+int nanvix_rfault_claim(vaddr_t vaddr, struct rfault *fault)
+{
+	void *lptr;   /* Local pointer.               */
+	raddr_t base; /* Base address of remote page. */
+	rpage_t pgnum;
+	int err;
+	int line;
+	int window;
+	int readahead;
+
+	/* Invalid fault. */
+	if (fault == NULL)
+		return (-EINVAL);
+
+	if (!maps_initialized)
+		nanvix_maps_init();
+
+	vaddr &= PAGE_MASK;
+	lptr = (void *)RADDR_INV(vaddr);
+
+	fault->vaddr = vaddr;
+	fault->nlines = 0;
+
+	/* Lookup remote address. */
+	if (nanvix_vmem_lookup(&base, NULL, lptr) < 0)
+		return (-EFAULT);
+
+	/* Back page with remote memory. */
+	if ((pgnum = nanvix_vmem_touch(base)) == RMEM_NULL)
+		return (-ENOMEM);
+
+	if ((err = nanvix_rcache_claim(pgnum, &line)) < 0)
+	{
+		/* Bypass mode: the page is fetched when it is linked. */
+		if (err == -ENOTSUP)
+			return (0);
+
+		return (err);
+	}
+
+	if (err > 0)
+		fault->lines[fault->nlines++] = line;
+
+	window = nanvix_rfault_window(base, &readahead);
+
+	/* Read ahead. */
+	for (int i = 1; readahead && (i < window); i++)
+	{
+		if ((pgnum = nanvix_vmem_translate(base + i)) == RMEM_NULL)
+			break;
+
+		/* Untouched. */
+		if (pgnum == RMEM_VMEM_RESERVED)
+			continue;
+
+		if ((err = nanvix_rcache_claim(pgnum, &line)) < 0)
+		{
+			/* Line is being filled, possibly by this fault. */
+			if (err == -EAGAIN)
+				continue;
+
+			break;
+		}
+
+		if (err > 0)
+			fault->lines[fault->nlines++] = line;
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rfault_fetch()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rfault_fetch() function fetches the cache lines claimed
+ * for the fault @p fault. It does not change the page cache nor the
+ * page maps, thus it may run while other faults are handled.
+ */
+void nanvix_rfault_fetch(struct rfault *fault)
+{
+	/* Invalid fault. */
+	if (fault == NULL)
+		return;
+
+	/* Failed lines are dropped and fetched again when linked. */
+	nanvix_rcache_fillv(fault->lines, fault->nlines);
+}
+
+/*============================================================================*
+ * nanvix_rfault_link()                                                       *
+ *============================================================================*/
+
+/**
+ * The nanvix_rfault_link() function completes the fault @p fault. The
+ * claimed cache lines are released, and the faulting page is linked.
+ * Following pages that are cached are linked as well, so that
+ * sequential accesses fault less often.
+ */
+int nanvix_rfault_link(struct rfault *fault)
+{
+	void *lptr;   /* Local pointer.               */
+	void *rptr;   /* Remote pointer.              */
+	raddr_t base; /* Base address of remote page. */
+	rpage_t pgnum;
+	int window;
+	int readahead;
+
+	/* Invalid fault. */
+	if (fault == NULL)
+		return (-EINVAL);
+
+	for (int i = 0; i < fault->nlines; i++)
+		nanvix_rcache_release(fault->lines[i]);
+	fault->nlines = 0;
+
+	lptr = (void *)RADDR_INV(fault->vaddr);
+
+	/* Lookup remote address. */
+	if (nanvix_vmem_lookup(&base, NULL, lptr) < 0)
+		return (-EFAULT);
+
+	/* Page is backed by remote memory on claim. */
+	if ((pgnum = nanvix_vmem_translate(base)) == RMEM_VMEM_RESERVED)
+		return (-EFAULT);
+
+	/* Get cached remote page. */
+	if ((rptr = nanvix_rcache_get(pgnum)) == NULL)
+		return (-EFAULT);
+
+	/* Link page. */
+	nanvix_maps_link(rptr, fault->vaddr);
+
+	window = nanvix_rfault_window(base, &readahead);
+
+	/* Fault-around. */
+	for (int i = 1; i < window; i++)
+	{
+		if ((pgnum = nanvix_vmem_translate(base + i)) == RMEM_NULL)
+			break;
+
+		/* Untouched. */
+		if (pgnum == RMEM_VMEM_RESERVED)
+			continue;
+
+		/* Not cached. */
+		if ((rptr = nanvix_rcache_peek(pgnum)) == NULL)
+			continue;
+
+		/* Already linked. */
+		if (nanvix_maps_search(rptr) >= 0)
+			continue;
+
+		nanvix_maps_link(rptr, fault->vaddr + (i << RMEM_BLOCK_SHIFT));
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rfault()                                                            *
+ *============================================================================*/
+
+/**
+ * The nanvix_rfault() function handles a fault on the local address
+ * @p vaddr. The faulting page is brought into the cache and linked to
+ * @p vaddr. Following pages that are already cached are linked as
+ * well, so that sequential accesses fault less often.
+ */
+int nanvix_rfault(vaddr_t vaddr)
+{
+	int err;
+	struct rfault fault;
+
+	if ((err = nanvix_rfault_claim(vaddr, &fault)) < 0)
+		return (err);
+
+	nanvix_rfault_fetch(&fault);
+
+	return (nanvix_rfault_link(&fault));
+}
@@ -23,12 +23,16 @@
  */
 
 #define __NEED_RMEM_SERVICE
+#define __NEED_MM_STUB
 
 #include <nanvix/servers/rmem.h>
 #include <nanvix/servers/spawn.h>
+#include <nanvix/runtime/rmem.h>
 #include <nanvix/runtime/stdikc.h>
+#include <nanvix/runtime/inbox.h>
 #include <nanvix/runtime/mailbox.h>
 #include <nanvix/runtime/portal.h>
+#include <nanvix/runtime/pm.h>
 #include <nanvix/sys/excp.h>
 #include <nanvix/sys/mailbox.h>
 #include <nanvix/sys/mutex.h>
@@ -50,26 +54,45 @@ static struct
 };
 
 /*============================================================================*
- * nanvix_rmem_alloc()                                                        *
+ * nanvix_rmem_nalloc()                                                       *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
+ * The nanvix_rmem_nalloc() function allocates a run of @p nblocks
+ * contiguous blocks of remote memory, with a single request. Runs are
+ * at most RMEM_RUN_MAX blocks long, and they live in a single server,
+ * which places them at a block number that is aligned to @p nblocks.
+ * Servers are picked round robin across calls.
+ *
+ * Upon successful completion, the number of the first block of the run
+ * is returned, and the run is freed block by block with
+ * nanvix_rmem_free(). Upon failure, RMEM_NULL is returned instead and
+ * no block is allocated.
  */
-rpage_t nanvix_rmem_alloc(void)
+rpage_t nanvix_rmem_nalloc(int nblocks)
 {
+	int tag;
 	int serverid;
 	static unsigned nallocs = 0;
 	struct rmem_message msg;
 
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX))
+		return (RMEM_NULL);
+
 	serverid = nallocs % RMEM_SERVERS_NUM;
 
 	/* Client not initialized.  */
 	if (!server[serverid].initialized)
-		return (-EINVAL);
+		return (RMEM_NULL);
+
+	/* Tag request. */
+	uassert((tag = nanvix_inbox_tag()) > 0);
 
 	/* Build operation header. */
 	message_header_build(&msg.header, RMEM_ALLOC);
+	msg.header.tag = tag;
+	msg.nblocks = nblocks;
 
 	/* Send operation header. */
 	uassert(
@@ -81,13 +104,15 @@ rpage_t nanvix_rmem_alloc(void)
 
 	/* Receive reply. */
 	uassert(
-		kmailbox_read(
-			stdinbox_get(),
+		nanvix_inbox_read(
+			tag,
 			&msg,
 			sizeof(struct rmem_message)
 		) == sizeof(struct rmem_message)
 	);
 
+	uassert(nanvix_inbox_untag(tag) == 0);
+
 	if (msg.errcode == RMEM_NULL)
 		return RMEM_NULL;
 
@@ -95,6 +120,18 @@ rpage_t nanvix_rmem_alloc(void)
 	return (msg.blknum);
 }
 
+/*============================================================================*
+ * nanvix_rmem_alloc()                                                        *
+ *============================================================================*/
+
+/**
+ * @todo TODO: Provide a detailed description for this function.
+ */
+rpage_t nanvix_rmem_alloc(void)
+{
+	return (nanvix_rmem_nalloc(1));
+}
+
 /*============================================================================*
  * nanvix_rmem_free()                                                         *
  *============================================================================*/
@@ -104,6 +141,7 @@ rpage_t nanvix_rmem_alloc(void)
  */
 int nanvix_rmem_free(rpage_t blknum)
 {
+	int tag;
 	int serverid;
 	struct rmem_message msg;
 
@@ -117,9 +155,14 @@ int nanvix_rmem_free(rpage_t blknum)
 	if (!server[serverid].initialized)
 		return (-EINVAL);
 
+	/* Tag request. */
+	uassert((tag = nanvix_inbox_tag()) > 0);
+
 	/* Build operation header. */
 	message_header_build(&msg.header, RMEM_MEMFREE);
+	msg.header.tag = tag;
 	msg.blknum = blknum;
+	msg.nblocks = 1;
 
 	/* Send operation header. */
 	uassert(
@@ -132,13 +175,15 @@ int nanvix_rmem_free(rpage_t blknum)
 
 	/* Receive reply. */
 	uassert(
-		kmailbox_read(
-			stdinbox_get(),
+		nanvix_inbox_read(
+			tag,
 			&msg,
 			sizeof(struct rmem_message)
 		) == sizeof(struct rmem_message)
 	);
 
+	uassert(nanvix_inbox_untag(tag) == 0);
+
 	return (msg.errcode);
 }
 
@@ -149,31 +194,52 @@ int nanvix_rmem_free(rpage_t blknum)
 #ifndef __RMEM_USES_MAILBOX
 
 /**
- * @todo TODO: Provide a detailed description for this function.
+ * The nanvix_rmem_nread_async() function sends a request for reading
+ * @p nblocks blocks from the remote memory, starting at block @p
+ * blknum, into @p buf. The request is not waited for, so that
+ * requests to different servers may proceed at the same time. The
+ * caller should complete it with nanvix_rmem_wait().
  */
-size_t nanvix_rmem_read(rpage_t blknum, void *buf)
+int nanvix_rmem_nread_async(struct rmem_request *req, rpage_t blknum, void *buf, int nblocks)
 {
+	int tag;
 	int serverid;
 	struct rmem_message msg;
 
+	/* Invalid request. */
+	if (req == NULL)
+		return (-EINVAL);
+
+	req->tag = -1;
+	req->ret = 0;
+
 	/* Invalid block number. */
 	if ((blknum == RMEM_NULL) || (RMEM_BLOCK_NUM(blknum) >= RMEM_NUM_BLOCKS))
-		return (0);
+		return (-EINVAL);
+
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX))
+		return (-EINVAL);
 
 	/* Invalid buffer. */
 	if (buf == NULL)
-		return (0);
+		return (-EINVAL);
 
 	serverid = RMEM_BLOCK_SERVER(blknum);
 
 	/* Client not initialized.  */
 	if (!server[serverid].initialized)
-		return (0);
+		return (-EINVAL);
+
+	/* Tag request. */
+	uassert((tag = nanvix_inbox_tag()) > 0);
 
 	/* Build operation header. */
 	message_header_build(&msg.header, RMEM_READ);
+	msg.header.tag = tag;
 
 	msg.blknum = blknum;
+	msg.nblocks = nblocks;
 
 	/* Send operation header. */
 	uassert(
@@ -184,10 +250,34 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 		) == 0
 	);
 
+	req->tag = tag;
+	req->serverid = serverid;
+	req->buf = buf;
+	req->nblocks = nblocks;
+
+	return (0);
+}
+
+/**
+ * The nanvix_rmem_wait() function waits for the request @p req to
+ * complete, and receives its data.
+ */
+size_t nanvix_rmem_wait(struct rmem_request *req)
+{
+	struct rmem_message msg;
+
+	/* Invalid request. */
+	if (req == NULL)
+		return (0);
+
+	/* Not issued. */
+	if (req->tag < 0)
+		return (req->ret);
+
 	/* Wait acknowledge. */
 	uassert(
-		kmailbox_read(
-			stdinbox_get(),
+		nanvix_inbox_read(
+			req->tag,
 			&msg,
 			sizeof(struct rmem_message)
 		) == sizeof(struct rmem_message)
@@ -198,28 +288,63 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 	uassert(
 		kportal_allow(
 			stdinportal_get(),
-			rmem_servers[serverid].nodenum,
+			rmem_servers[req->serverid].nodenum,
 			msg.header.portal_port
 		) == 0
 	);
 	uassert(
 		kportal_read(
 			stdinportal_get(),
-			buf,
-			RMEM_BLOCK_SIZE
-		) == RMEM_BLOCK_SIZE
+			req->buf,
+			req->nblocks*RMEM_BLOCK_SIZE
+		) == req->nblocks*RMEM_BLOCK_SIZE
 	);
 
 	/* Receive reply. */
 	uassert(
-		kmailbox_read(
-			stdinbox_get(),
+		nanvix_inbox_read(
+			req->tag,
 			&msg,
 			sizeof(struct rmem_message)
 		) == sizeof(struct rmem_message)
 	);
 
-	return ((msg.errcode < 0) ? 0 : RMEM_BLOCK_SIZE);
+	uassert(nanvix_inbox_untag(req->tag) == 0);
+
+	req->tag = -1;
+	req->ret = (msg.errcode < 0) ? 0 : req->nblocks*RMEM_BLOCK_SIZE;
+
+	return (req->ret);
+}
+
+/**
+ * The nanvix_rmem_nread() function reads a run of @p nblocks blocks
+ * of remote memory, starting at block @p blknum, into @p buf. The run
+ * is at most RMEM_RUN_MAX blocks long, it must not cross the end of
+ * the server of @p blknum, and it is transferred with a single request.
+ * Blocks of the run that are not allocated to the caller are holes,
+ * and they read as zeros.
+ *
+ * Upon successful completion, @p nblocks*RMEM_BLOCK_SIZE is returned,
+ * even if some blocks of the run were holes. If the request is invalid
+ * or every block of the run is a hole, zero is returned instead.
+ */
+size_t nanvix_rmem_nread(rpage_t blknum, void *buf, int nblocks)
+{
+	struct rmem_request req;
+
+	if (nanvix_rmem_nread_async(&req, blknum, buf, nblocks) < 0)
+		return (0);
+
+	return (nanvix_rmem_wait(&req));
+}
+
+/**
+ * @todo TODO: Provide a detailed description for this function.
+ */
+size_t nanvix_rmem_read(rpage_t blknum, void *buf)
+{
+	return (nanvix_rmem_nread(blknum, buf, 1));
 }
 
 #else
@@ -229,6 +354,7 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
  */
 size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 {
+	int tag;
 	int serverid;
 	struct rmem_message msg;
 
@@ -246,10 +372,15 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 	if (!server[serverid].initialized)
 		return (0);
 
+	/* Tag request. */
+	uassert((tag = nanvix_inbox_tag()) > 0);
+
 	/* Build operation header. */
 	message_header_build(&msg.header, RMEM_READ);
+	msg.header.tag = tag;
 
 	msg.blknum = blknum;
+	msg.nblocks = 1;
 
 	/* Send operation header. */
 	uassert(
@@ -264,8 +395,8 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 	{
 		/* Wait acknowledge. */
 		uassert(
-			kmailbox_read(
-				stdinbox_get(),
+			nanvix_inbox_read(
+				tag,
 				&msg,
 				sizeof(struct rmem_message)
 			) == sizeof(struct rmem_message)
@@ -278,16 +409,93 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 
 	/* Receive reply. */
 	uassert(
-		kmailbox_read(
-			stdinbox_get(),
+		nanvix_inbox_read(
+			tag,
 			&msg,
 			sizeof(struct rmem_message)
 		) == sizeof(struct rmem_message)
 	);
 
+	uassert(nanvix_inbox_untag(tag) == 0);
+
 	return ((msg.errcode < 0) ? 0 : RMEM_BLOCK_SIZE);
 }
 
+/**
+ * The nanvix_rmem_nread() function reads a run of @p nblocks blocks
+ * of remote memory, starting at block @p blknum, into @p buf. The run
+ * is at most RMEM_RUN_MAX blocks long. Blocks of the run that cannot
+ * be read are holes, and they read as zeros.
+ *
+ * Upon successful completion, @p nblocks*RMEM_BLOCK_SIZE is returned,
+ * even if some blocks of the run were holes. If the request is invalid
+ * or every block of the run is a hole, zero is returned instead.
+ *
+ * @note Runs are transferred block by block.
+ */
+size_t nanvix_rmem_nread(rpage_t blknum, void *buf, int nblocks)
+{
+	int nholes = 0;
+
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX))
+		return (0);
+
+	/* Invalid buffer. */
+	if (buf == NULL)
+		return (0);
+
+	for (int i = 0; i < nblocks; i++)
+	{
+		char *blk = &((char *)buf)[i*RMEM_BLOCK_SIZE];
+
+		/* Hole. */
+		if (nanvix_rmem_read(blknum + i, blk) == 0)
+		{
+			umemset(blk, 0, RMEM_BLOCK_SIZE);
+			nholes++;
+		}
+	}
+
+	return ((nholes == nblocks) ? 0 : nblocks*RMEM_BLOCK_SIZE);
+}
+
+
+/**
+ * The nanvix_rmem_nread_async() function reads @p nblocks blocks from
+ * the remote memory, starting at block @p blknum, into @p buf.
+ *
+ * @note Blocks are streamed through the mailbox, and their
+ * acknowledges would not fit in the parked messages of the inbox.
+ * Thus, the read completes before the function returns.
+ */
+int nanvix_rmem_nread_async(struct rmem_request *req, rpage_t blknum, void *buf, int nblocks)
+{
+	/* Invalid request. */
+	if (req == NULL)
+		return (-EINVAL);
+
+	req->tag = -1;
+	req->buf = buf;
+	req->nblocks = nblocks;
+	req->ret = nanvix_rmem_nread(blknum, buf, nblocks);
+
+	return (0);
+}
+
+/**
+ * The nanvix_rmem_wait() function returns the result of the request
+ * @p req.
+ */
+size_t nanvix_rmem_wait(struct rmem_request *req)
+{
+	/* Invalid request. */
+	if (req == NULL)
+		return (0);
+
+	return (req->ret);
+}
+
 #endif
 
 /*============================================================================*
@@ -297,10 +505,21 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 #ifndef __RMEM_USES_MAILBOX
 
 /**
- * @todo TODO: Provide a detailed description for this function.
+ * The nanvix_rmem_nwrite() function writes @p buf to a run of @p
+ * nblocks blocks of remote memory, starting at block @p blknum. The run
+ * is at most RMEM_RUN_MAX blocks long, it must not cross the end of
+ * the server of @p blknum, and it is transferred with a single request.
+ * Writes to blocks of the run that are not allocated to the caller are
+ * dropped.
+ *
+ * Upon successful completion, @p nblocks*RMEM_BLOCK_SIZE is returned,
+ * even if writes to some blocks of the run were dropped. If the
+ * request is invalid or every block of the run is a hole, zero is
+ * returned instead.
  */
-size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
+size_t nanvix_rmem_nwrite(rpage_t blknum, const void *buf, int nblocks)
 {
+	int tag;
 	int serverid;
 	struct rmem_message msg;
 
@@ -308,6 +527,10 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 	if ((blknum == RMEM_NULL) || (RMEM_BLOCK_NUM(blknum) >= RMEM_NUM_BLOCKS))
 		return (0);
 
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX))
+		return (0);
+
 	/* Invalid buffer. */
 	if (buf == NULL)
 		return (0);
@@ -318,13 +541,18 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 	if (!server[serverid].initialized)
 		return (0);
 
+	/* Tag request. */
+	uassert((tag = nanvix_inbox_tag()) > 0);
+
 	/* Build operation header. */
 	message_header_build2(
 		&msg.header,
 		RMEM_WRITE,
 		nanvix_portal_get_port(server[serverid].outportal)
 	);
+	msg.header.tag = tag;
 	msg.blknum = blknum;
+	msg.nblocks = nblocks;
 
 	/* Send operation header. */
 	uassert(
@@ -339,20 +567,30 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 		nanvix_portal_write(
 			server[serverid].outportal,
 			buf,
-			RMEM_BLOCK_SIZE
-		) == RMEM_BLOCK_SIZE
+			nblocks*RMEM_BLOCK_SIZE
+		) == nblocks*RMEM_BLOCK_SIZE
 	);
 
 	/* Receive reply. */
 	uassert(
-		kmailbox_read(
-			stdinbox_get(),
+		nanvix_inbox_read(
+			tag,
 			&msg,
 			sizeof(struct rmem_message)
 		) == sizeof(struct rmem_message)
 	);
 
-	return ((msg.errcode < 0) ? 0 : RMEM_BLOCK_SIZE);
+	uassert(nanvix_inbox_untag(tag) == 0);
+
+	return ((msg.errcode < 0) ? 0 : nblocks*RMEM_BLOCK_SIZE);
+}
+
+/**
+ * @todo TODO: Provide a detailed description for this function.
+ */
+size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
+{
+	return (nanvix_rmem_nwrite(blknum, buf, 1));
 }
 
 #else
@@ -362,6 +600,7 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
  */
 size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 {
+	int tag;
 	int serverid;
 	struct rmem_message msg;
 
@@ -379,6 +618,9 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 	if (!server[serverid].initialized)
 		return (0);
 
+	/* Tag request. */
+	uassert((tag = nanvix_inbox_tag()) > 0);
+
 	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i += RMEM_PAYLOAD_SIZE)
 	{
 		message_header_build2(
@@ -386,7 +628,9 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 			RMEM_WRITE,
 			nanvix_portal_get_port(server[serverid].outportal)
 		);
+		msg.header.tag = tag;
 		msg.blknum = blknum;
+		msg.nblocks = 1;
 		msg.offset = i;
 
 		umemcpy(&msg.payload, &((const char *)buf)[i], RMEM_PAYLOAD_SIZE);
@@ -397,20 +641,57 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 				&msg, sizeof(struct rmem_message)
 			) == 0
 		);
-
-		/* Receive reply. */
-		uassert(
-			kmailbox_read(
-				stdinbox_get(),
-				&msg,
-				sizeof(struct rmem_message)
-			) == sizeof(struct rmem_message)
-		);
 	}
 
+	/* Receive reply, for the whole block. */
+	uassert(
+		nanvix_inbox_read(
+			tag,
+			&msg,
+			sizeof(struct rmem_message)
+		) == sizeof(struct rmem_message)
+	);
+
+	uassert(nanvix_inbox_untag(tag) == 0);
+
 	return ((msg.errcode < 0) ? 0 : RMEM_BLOCK_SIZE);
 }
 
+/**
+ * The nanvix_rmem_nwrite() function writes @p buf to a run of @p
+ * nblocks blocks of remote memory, starting at block @p blknum. The run
+ * is at most RMEM_RUN_MAX blocks long. Writes to blocks of the run
+ * that cannot be written are dropped.
+ *
+ * Upon successful completion, @p nblocks*RMEM_BLOCK_SIZE is returned,
+ * even if writes to some blocks of the run were dropped. If the
+ * request is invalid or every block of the run is a hole, zero is
+ * returned instead.
+ *
+ * @note Runs are transferred block by block.
+ */
+size_t nanvix_rmem_nwrite(rpage_t blknum, const void *buf, int nblocks)
+{
+	int nholes = 0;
+
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX))
+		return (0);
+
+	/* Invalid buffer. */
+	if (buf == NULL)
+		return (0);
+
+	for (int i = 0; i < nblocks; i++)
+	{
+		/* Hole. */
+		if (nanvix_rmem_write(blknum + i, &((const char *)buf)[i*RMEM_BLOCK_SIZE]) == 0)
+			nholes++;
+	}
+
+	return ((nholes == nblocks) ? 0 : nblocks*RMEM_BLOCK_SIZE);
+}
+
 #endif
 
 /*============================================================================*
@@ -450,6 +731,18 @@ int nanvix_rmem_shutdown(void)
  */
 int __nanvix_rmem_setup(void)
 {
+	/*
+	 * Wait for all servers to come up, so
+	 * that opens below hit the name cache.
+	 */
+	for (int i = 0; i < RMEM_SERVERS_NUM; i++)
+	{
+		int ret;
+
+		if ((ret = name_wait(rmem_servers[i].name)) < 0)
+			return (ret);
+	}
+
 	/* Open connections to remote memory servers. */
 	for (int i = 0; i < RMEM_SERVERS_NUM; i++)
 	{
@@ -26,6 +26,7 @@
 
 #include <nanvix/servers/name.h>
 #include <nanvix/servers/spawn.h>
+#include <nanvix/runtime/rpc.h>
 #include <nanvix/runtime/stdikc.h>
 #include <nanvix/sys/mailbox.h>
 #include <nanvix/sys/mutex.h>
@@ -34,15 +35,162 @@
 #include <posix/stdbool.h>
 
 /**
- * @brief Mailbox for small messages.
+ * @brief Table of Name Servers.
  */
-static int server;
+struct name_servers_info name_servers[NAME_SERVERS_NUM] = {
+	{ NAME_SERVER_0_NODE, NAME_SERVER_PORT_NUM },
+#if (NAME_SERVERS_NUM > 1)
+	{ NAME_SERVER_1_NODE, NAME_SERVER_PORT_NUM },
+#endif
+};
+
+/**
+ * @brief Mailboxes for small messages (one per Name Server).
+ */
+static int server[NAME_SERVERS_NUM];
 
 /**
  * @brief Is the name service initialized ?
  */
 static bool initialized = false;
 
+/**
+ * @brief Number of entries in the name cache.
+ */
+#define NAME_CACHE_SIZE 16
+
+/**
+ * @brief Lifetime of a cached name (in cycles).
+ */
+#ifndef __NAME_CACHE_TTL
+#define NAME_CACHE_TTL CLUSTER_FREQ
+#else
+#define NAME_CACHE_TTL __NAME_CACHE_TTL
+#endif
+
+/**
+ * @brief Name cache.
+ *
+ * Resolved names are kept for NAME_CACHE_TTL cycles, so that repeated
+ * opens of the same service do not reach the Name Server.
+ */
+static struct
+{
+	int nodenum;                     /**< NoC node (-1 if invalid). */
+	char name[NANVIX_PROC_NAME_MAX]; /**< Process name.             */
+	uint64_t timestamp;              /**< Time of resolution.       */
+} name_cache[NAME_CACHE_SIZE] = {
+	[0 ... (NAME_CACHE_SIZE - 1)] = { .nodenum = -1 }
+};
+
+/*============================================================================*
+ * Name Cache                                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Searches for a cached name.
+ *
+ * @param name Target name.
+ *
+ * @returns If @p name is cached, the index of its entry is returned.
+ * Otherwise, -1 is returned instead.
+ */
+static int name_cache_search(const char *name)
+{
+	for (int i = 0; i < NAME_CACHE_SIZE; i++)
+	{
+		if (name_cache[i].nodenum < 0)
+			continue;
+
+		if (!ustrcmp(name_cache[i].name, name))
+			return (i);
+	}
+
+	return (-1);
+}
+
+/**
+ * @brief Resolves a name using the name cache.
+ *
+ * @param name Target name.
+ *
+ * @returns If @p name is cached and its lease has not expired, the
+ * NoC node of @p name is returned. Otherwise, -1 is returned instead.
+ */
+static int name_cache_get(const char *name)
+{
+	int i;
+	uint64_t now;
+
+	if ((i = name_cache_search(name)) < 0)
+		return (-1);
+
+	/* Lease expired. */
+	if ((kernel_clock(&now) < 0) || ((now - name_cache[i].timestamp) > NAME_CACHE_TTL))
+	{
+		name_cache[i].nodenum = -1;
+		return (-1);
+	}
+
+	return (name_cache[i].nodenum);
+}
+
+/**
+ * @brief Caches a resolved name.
+ *
+ * @param name    Target name.
+ * @param nodenum NoC node of @p name.
+ */
+static void name_cache_put(const char *name, int nodenum)
+{
+	int victim;
+	uint64_t now;
+
+	if (kernel_clock(&now) < 0)
+		return;
+
+	/* Replace old entry, a free one, or the oldest one. */
+	if ((victim = name_cache_search(name)) < 0)
+	{
+		victim = 0;
+		for (int i = 0; i < NAME_CACHE_SIZE; i++)
+		{
+			if (name_cache[i].nodenum < 0)
+			{
+				victim = i;
+				break;
+			}
+
+			if (name_cache[i].timestamp < name_cache[victim].timestamp)
+				victim = i;
+		}
+	}
+
+	name_cache[victim].nodenum = nodenum;
+	name_cache[victim].timestamp = now;
+	ustrcpy(name_cache[victim].name, name);
+}
+
+/**
+ * The name_cache_invalidate() function drops the cached resolution of
+ * @p name, if any, so that the next lookup reaches the Name Server. If
+ * @p name is NULL, the whole cache is dropped.
+ */
+void name_cache_invalidate(const char *name)
+{
+	int i;
+
+	if (name == NULL)
+	{
+		for (i = 0; i < NAME_CACHE_SIZE; i++)
+			name_cache[i].nodenum = -1;
+		return;
+	}
+
+	if ((i = name_cache_search(name)) >= 0)
+		name_cache[i].nodenum = -1;
+}
+
 /*============================================================================*
  * __name_setup()                                                             *
  *============================================================================*/
@@ -56,9 +204,12 @@ int __name_setup(void)
 	if (initialized)
 		return (0);
 
-	/* Open connection with Name Server. */
-	if ((server = kmailbox_open(NAME_SERVER_NODE, NAME_SERVER_PORT_NUM)) < 0)
-		return (-1);
+	/* Open connections with Name Servers. */
+	for (int i = 0; i < NAME_SERVERS_NUM; i++)
+	{
+		if ((server[i] = kmailbox_open(name_servers[i].nodenum, name_servers[i].portnum)) < 0)
+			return (-1);
+	}
 
 	initialized = true;
 
@@ -78,9 +229,12 @@ int __name_cleanup(void)
 	if (!initialized)
 		return (0);
 
-	/* Close connection with Name Server. */
-	if (kmailbox_close(server) < 0)
-		return (-EAGAIN);
+	/* Close connections with Name Servers. */
+	for (int i = 0; i < NAME_SERVERS_NUM; i++)
+	{
+		if (kmailbox_close(server[i]) < 0)
+			return (-EAGAIN);
+	}
 
 	initialized = false;
 
@@ -107,19 +261,326 @@ int name_lookup(const char *name)
 	if ((ret = name_is_valid(name)) < 0)
 		return (ret);
 
+	/* Cached. */
+	if ((ret = name_cache_get(name)) >= 0)
+		return (ret);
+
 	/* Build operation header. */
 	message_header_build(&msg.header, NAME_LOOKUP);
 	ustrcpy(msg.op.lookup.name, name);
 
-	if ((ret = kmailbox_write(server, &msg, sizeof(struct name_message))) != sizeof(struct name_message))
+	if ((ret = nanvix_rpc_call(server[name_server_of(name)], &msg, sizeof(struct name_message))) < 0)
 		return (ret);
 
-	if ((ret = kmailbox_read(stdinbox_get(), &msg, sizeof(struct name_message))) != sizeof(struct name_message))
+	if (msg.op.ret.nodenum >= 0)
+		name_cache_put(name, msg.op.ret.nodenum);
+
+	return (msg.op.ret.nodenum);
+}
+
+/*============================================================================*
+ * name_lookup_age()                                                          *
+ *============================================================================*/
+
+/**
+ * The name_lookup_age() function resolves @p name at the Name Server,
+ * bypassing the name cache, and stores in @p age the number of cycles
+ * since the NoC node of @p name last sent a heartbeat. If that node
+ * never sent one, NAME_AGE_UNKNOWN is stored instead. Names of nodes
+ * that stopped sending heartbeats are unlinked by the server, so this
+ * function may be used to fail over from a stale cached resolution.
+ */
+int name_lookup_age(const char *name, uint64_t *age)
+{
+	int ret;
+	struct name_message msg;
+
+	/* Initilize name client. */
+	if (!initialized)
+		return (-EAGAIN);
+
+	/* Invalid name. */
+	if ((ret = name_is_valid(name)) < 0)
+		return (ret);
+
+	/* Invalid storage location. */
+	if (age == NULL)
+		return (-EINVAL);
+
+	name_cache_invalidate(name);
+
+	/* Build operation header. */
+	message_header_build(&msg.header, NAME_LOOKUP);
+	ustrcpy(msg.op.lookup.name, name);
+
+	if ((ret = nanvix_rpc_call(server[name_server_of(name)], &msg, sizeof(struct name_message))) < 0)
+		return (ret);
+
+	if (msg.op.ret.nodenum < 0)
+		return ((msg.op.ret.errcode < 0) ? msg.op.ret.errcode : -ENOENT);
+
+	name_cache_put(name, msg.op.ret.nodenum);
+	*age = msg.op.ret.age;
+
+	return (msg.op.ret.nodenum);
+}
+
+/*============================================================================*
+ * name_wait()                                                                *
+ *============================================================================*/
+
+/**
+ * The name_wait() function blocks the calling process until @p name
+ * is linked in the Name Service, and then returns the NoC node ID that
+ * @p name was linked to. If @p name is already linked, this function
+ * returns immediately.
+ */
+int name_wait(const char *name)
+{
+	int ret;
+	struct name_message msg;
+
+	/* Initilize name client. */
+	if (!initialized)
+		return (-EAGAIN);
+
+	/* Invalid name. */
+	if ((ret = name_is_valid(name)) < 0)
+		return (ret);
+
+	/* Cached. */
+	if ((ret = name_cache_get(name)) >= 0)
 		return (ret);
 
+	/* Build operation header. */
+	message_header_build(&msg.header, NAME_WAIT);
+	ustrcpy(msg.op.lookup.name, name);
+
+	if ((ret = nanvix_rpc_call(server[name_server_of(name)], &msg, sizeof(struct name_message))) < 0)
+		return (ret);
+
+	if (msg.op.ret.nodenum < 0)
+		return ((msg.op.ret.errcode < 0) ? msg.op.ret.errcode : -ENOENT);
+
+	name_cache_put(name, msg.op.ret.nodenum);
+
 	return (msg.op.ret.nodenum);
 }
 
+/*============================================================================*
+ * name_many()                                                                *
+ *============================================================================*/
+
+/**
+ * @brief Marks a name whose result is still pending in a batch.
+ */
+#define NAME_PENDING (-EAGAIN)
+
+/**
+ * @brief Sends a batch of names to a Name Server.
+ *
+ * @param opcode   Batched operation.
+ * @param serverid Target Name Server.
+ * @param names    Names.
+ * @param idx      Indexes of the names in the batch.
+ * @param count    Number of names in the batch.
+ *
+ * @returns Upon successful completion, the tag of the request is
+ * returned. Upon failure, a negative error code is returned instead.
+ */
+static int name_batch_send(
+	int opcode,
+	int serverid,
+	const char **names,
+	const int *idx,
+	int count
+)
+{
+	size_t off;
+	size_t len;
+	struct name_message msg;
+
+	/* Build operation header. */
+	message_header_build(&msg.header, opcode);
+	msg.op.many.count = count;
+	off = 0;
+	for (int i = 0; i < count; i++, off += len)
+	{
+		len = ustrlen(names[idx[i]]) + 1;
+		umemcpy(&msg.op.many.names[off], names[idx[i]], len);
+	}
+
+	return (nanvix_rpc_send(server[serverid], &msg, sizeof(struct name_message)));
+}
+
+/**
+ * @brief Receives the results of a batch of names.
+ *
+ * @param tag     Tag of the request.
+ * @param idx     Indexes of the names in the batch.
+ * @param count   Number of names in the batch.
+ * @param results Store location for per-name results.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure,
+ * a negative error code is returned instead.
+ */
+static int name_batch_recv(int tag, const int *idx, int count, int *results)
+{
+	int ret;
+	struct name_message msg;
+
+	if ((ret = nanvix_rpc_recv(tag, &msg, sizeof(struct name_message))) < 0)
+		return (ret);
+
+	/* Bad batch. */
+	if (msg.op.ret_many.count != count)
+		return ((msg.op.ret_many.errcode < 0) ? msg.op.ret_many.errcode : -EINVAL);
+
+	for (int i = 0; i < count; i++)
+		results[idx[i]] = msg.op.ret_many.values[i];
+
+	return (0);
+}
+
+/**
+ * @brief Runs a batched name operation.
+ *
+ * @param opcode  Batched operation.
+ * @param names   Names.
+ * @param results Per-name results (NAME_PENDING marks names to send).
+ * @param n       Number of names.
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure,
+ * a negative error code is returned instead.
+ *
+ * @note Names are grouped by Name Server, and each group is sent in as
+ * few messages as fit. In each round, one batch is sent to every Name
+ * Server before any results are awaited, so that Name Servers work in
+ * parallel.
+ */
+static int name_many(int opcode, const char **names, int *results, int n)
+{
+	int ret;
+	int err;
+	int nsent;
+	size_t len;
+	size_t size;
+	int tags[NAME_SERVERS_NUM];
+	int count[NAME_SERVERS_NUM];
+	int cursor[NAME_SERVERS_NUM];
+	int idx[NAME_SERVERS_NUM][NAME_BATCH_MAX];
+
+	for (int s = 0; s < NAME_SERVERS_NUM; s++)
+		cursor[s] = 0;
+
+	err = 0;
+	do
+	{
+		nsent = 0;
+
+		for (int s = 0; s < NAME_SERVERS_NUM; s++)
+		{
+			tags[s] = -1;
+			count[s] = 0;
+		}
+
+		/* Send one batch to each Name Server. */
+		for (int s = 0; (s < NAME_SERVERS_NUM) && (err == 0); s++)
+		{
+			size = 0;
+
+			for (; cursor[s] < n; cursor[s]++)
+			{
+				int i = cursor[s];
+
+				/* Skip names of other servers, and those already done. */
+				if ((results[i] != NAME_PENDING) || (name_server_of(names[i]) != s))
+					continue;
+
+				len = ustrlen(names[i]) + 1;
+
+				/* Batch is full. */
+				if ((count[s] == NAME_BATCH_MAX) || ((size + len) > NAME_BATCH_SIZE))
+					break;
+
+				idx[s][count[s]++] = i;
+				size += len;
+			}
+
+			if (count[s] == 0)
+				continue;
+
+			if ((tags[s] = name_batch_send(opcode, s, names, idx[s], count[s])) < 0)
+			{
+				err = tags[s];
+				break;
+			}
+
+			nsent++;
+		}
+
+		/* Collect results, even if some batch has failed. */
+		for (int s = 0; s < NAME_SERVERS_NUM; s++)
+		{
+			if (tags[s] < 0)
+				continue;
+
+			if (((ret = name_batch_recv(tags[s], idx[s], count[s], results)) < 0) && (err == 0))
+				err = ret;
+		}
+	} while ((nsent > 0) && (err == 0));
+
+	return (err);
+}
+
+/*============================================================================*
+ * name_lookup_many()                                                         *
+ *============================================================================*/
+
+/**
+ * The name_lookup_many() function converts the @p n names in @p names
+ * into NoC node IDs, and places them in @p nodenums. Names that cannot
+ * be converted get a negative error code instead. Cached names are not
+ * sent, and the others are sent in batches, so that resolving several
+ * names costs a handful of messages.
+ */
+int name_lookup_many(const char **names, int *nodenums, int n)
+{
+	int ret;
+
+	/* Initilize name client. */
+	if (!initialized)
+		return (-EAGAIN);
+
+	/* Invalid arguments. */
+	if ((names == NULL) || (nodenums == NULL) || (n < 0))
+		return (-EINVAL);
+
+	for (int i = 0; i < n; i++)
+	{
+		/* Invalid name. */
+		if ((nodenums[i] = name_is_valid(names[i])) < 0)
+			continue;
+
+		/* Cached. */
+		if ((nodenums[i] = name_cache_get(names[i])) >= 0)
+			continue;
+
+		nodenums[i] = NAME_PENDING;
+	}
+
+	if ((ret = name_many(NAME_LOOKUP_MANY, names, nodenums, n)) < 0)
+		return (ret);
+
+	for (int i = 0; i < n; i++)
+	{
+		if (nodenums[i] >= 0)
+			name_cache_put(names[i], nodenums[i]);
+	}
+
+	return (0);
+}
+
 /*============================================================================*
  * name_link()                                                                *
  *============================================================================*/
@@ -148,10 +609,7 @@ int name_link(int nodenum, const char *name)
 	message_header_build(&msg.header, NAME_LINK);
 	ustrcpy(msg.op.link.name, name);
 
-	if ((ret = kmailbox_write(server, &msg, sizeof(struct name_message))) != sizeof(struct name_message))
-		return (ret);
-
-	if ((ret = kmailbox_read(stdinbox_get(), &msg, sizeof(struct name_message))) != sizeof(struct name_message))
+	if ((ret = nanvix_rpc_call(server[name_server_of(name)], &msg, sizeof(struct name_message))) < 0)
 		return (ret);
 
 	if (msg.header.opcode == NAME_SUCCESS)
@@ -160,6 +618,42 @@ int name_link(int nodenum, const char *name)
 	return (msg.op.ret.errcode);
 }
 
+/*============================================================================*
+ * name_link_many()                                                           *
+ *============================================================================*/
+
+/**
+ * The name_link_many() function links the @p n names in @p names to the
+ * NoC node @p nodenum. The result of each link is placed in @p results:
+ * zero on success, and a negative error code on failure. Names are sent
+ * in batches.
+ */
+int name_link_many(int nodenum, const char **names, int *results, int n)
+{
+	/* Initilize name client. */
+	if (!initialized)
+		return (-EAGAIN);
+
+	/* Invalid NoC node ID. */
+	if (!proc_is_valid(nodenum))
+		return (-EINVAL);
+
+	/* Invalid arguments. */
+	if ((names == NULL) || (results == NULL) || (n < 0))
+		return (-EINVAL);
+
+	for (int i = 0; i < n; i++)
+	{
+		/* Invalid name. */
+		if ((results[i] = name_is_valid(names[i])) < 0)
+			continue;
+
+		results[i] = NAME_PENDING;
+	}
+
+	return (name_many(NAME_LINK_MANY, names, results, n));
+}
+
 /*============================================================================*
  * name_unlink()                                                              *
  *============================================================================*/
@@ -180,14 +674,13 @@ int name_unlink(const char *name)
 	if ((ret = name_is_valid(name)) < 0)
 		return (ret);
 
+	name_cache_invalidate(name);
+
 	/* Build operation header. */
 	message_header_build(&msg.header, NAME_UNLINK);
 	ustrcpy(msg.op.unlink.name, name);
 
-	if ((ret = kmailbox_write(server, &msg, sizeof(struct name_message))) != sizeof(struct name_message))
-		return (ret);
-
-	if ((ret = kmailbox_read(stdinbox_get(), &msg, sizeof(struct name_message))) != sizeof(struct name_message))
+	if ((ret = nanvix_rpc_call(server[name_server_of(name)], &msg, sizeof(struct name_message))) < 0)
 		return (ret);
 
 	if (msg.header.opcode == NAME_SUCCESS)
@@ -197,13 +690,142 @@ int name_unlink(const char *name)
 }
 
 /*============================================================================*
- * name_heartbeat()                                                           *
+ * name_stats()                                                               *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * The name_stats() function gathers statistics from all Name Servers
+ * and stores their sum in @p buf. Each server is asked only once.
+ * Service times are the time that servers take to handle requests, and
+ * do not include network time. Total times are rebuilt from means, so
+ * they are exact only up to one cycle per request.
  */
-int name_heartbeat(void)
+int name_stats(struct name_stats *buf)
+{
+	int ret;
+	struct name_message msg;
+
+	/* Initilize name client. */
+	if (!initialized)
+		return (-EAGAIN);
+
+	/* Invalid storage location. */
+	if (buf == NULL)
+		return (-EINVAL);
+
+	umemset(buf, 0, sizeof(struct name_stats));
+
+	for (int i = 0; i < NAME_SERVERS_NUM; i++)
+	{
+		/* Build operation header. */
+		message_header_build(&msg.header, NAME_STATS);
+
+		if ((ret = nanvix_rpc_call(server[i], &msg, sizeof(struct name_message))) < 0)
+			return (ret);
+
+		if (msg.op.ret_stats.errcode < 0)
+			return (msg.op.ret_stats.errcode);
+
+		buf->nnames += msg.op.ret_stats.nnames;
+		buf->nlinks += msg.op.ret_stats.nlinks;
+		buf->nunlinks += msg.op.ret_stats.nunlinks;
+		buf->nlookups += msg.op.ret_stats.nlookups;
+		buf->nevictions += msg.op.ret_stats.nevictions;
+
+		/* Timed operations come in opcode order. */
+		for (int opcode = 0, j = 0; opcode < NAME_OPCODES_NUM; opcode++)
+		{
+			struct name_latency *latency;
+
+			if (!name_opcode_is_timed(opcode))
+				continue;
+
+			latency = &buf->latency[opcode];
+			latency->count += msg.op.ret_stats.latency[j].count;
+			latency->cycles += (uint64_t) msg.op.ret_stats.latency[j].mean*msg.op.ret_stats.latency[j].count;
+			if (msg.op.ret_stats.latency[j].max > latency->max)
+				latency->max = msg.op.ret_stats.latency[j].max;
+			j++;
+		}
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * name_list()                                                                *
+ *============================================================================*/
+
+/**
+ * @brief Shift of the Name Server in a listing cursor.
+ */
+#define NAME_LIST_SHIFT 16
+
+/**
+ * The name_list() function gets the first name registered at or after
+ * @p cursor. Names kept by all Name Servers are enumerated, one server
+ * after the other. Names that are linked or unlinked in the meantime
+ * may or may not be seen.
+ */
+int name_list(int cursor, char *name, int *nodenum, uint64_t *age)
+{
+	int ret;
+	struct name_message msg;
+
+	/* Initilize name client. */
+	if (!initialized)
+		return (-EAGAIN);
+
+	/* Invalid cursor. */
+	if (cursor < 0)
+		return (-EINVAL);
+
+	/* Invalid storage location. */
+	if ((name == NULL) || (nodenum == NULL) || (age == NULL))
+		return (-EINVAL);
+
+	for (int i = (cursor >> NAME_LIST_SHIFT); i < NAME_SERVERS_NUM; i++)
+	{
+		/* Build operation header. */
+		message_header_build(&msg.header, NAME_LIST);
+		msg.op.list.cursor = cursor & ((1 << NAME_LIST_SHIFT) - 1);
+
+		if ((ret = nanvix_rpc_call(server[i], &msg, sizeof(struct name_message))) < 0)
+			return (ret);
+
+		/* Found. */
+		if (msg.op.ret_list.nodenum >= 0)
+		{
+			ustrcpy(name, msg.op.ret_list.name);
+			*nodenum = msg.op.ret_list.nodenum;
+			*age = msg.op.ret_list.age;
+
+			return ((i << NAME_LIST_SHIFT) | msg.op.ret_list.next);
+		}
+
+		/* Failed. */
+		if (msg.op.ret_list.errcode != -ENOENT)
+			return (msg.op.ret_list.errcode);
+
+		cursor = 0;
+	}
+
+	return (-ENOENT);
+}
+
+/*============================================================================*
+ * name_alive()                                                               *
+ *============================================================================*/
+
+/**
+ * @brief Sends a heartbeat to all Name Servers.
+ *
+ * @param track Keep track of the calling node?
+ *
+ * @returns Upon successful completion, zero is returned. Upon failure,
+ * a negative error code is returned instead.
+ */
+static int name_alive(int track)
 {
 	int ret;
 	struct name_message msg;
@@ -214,15 +836,48 @@ int name_heartbeat(void)
 
 	/* Build operation header. */
 	message_header_build(&msg.header, NAME_ALIVE);
+	msg.op.heartbeat.track = track;
 	if ((ret = kernel_clock(&msg.op.heartbeat.timestamp)) < 0)
 		return (ret);
 
-	if ((ret = kmailbox_write(server, &msg, sizeof(struct name_message))) != sizeof(struct name_message))
-		return (ret);
+	/* Every Name Server keeps names of this node. */
+	for (int i = 0; i < NAME_SERVERS_NUM; i++)
+	{
+		if ((ret = kmailbox_write(server[i], &msg, sizeof(struct name_message))) != sizeof(struct name_message))
+			return (ret);
+	}
 
 	return (0);
 }
 
+/*============================================================================*
+ * name_heartbeat()                                                           *
+ *============================================================================*/
+
+/**
+ * The name_heartbeat() function tells Name Servers that the calling
+ * node is alive. From then on, its names are unlinked if it stays
+ * silent for longer than NAME_ALIVE_TIMEOUT, so the caller should keep
+ * sending heartbeats or call name_heartbeat_stop().
+ */
+int name_heartbeat(void)
+{
+	return (name_alive(1));
+}
+
+/*============================================================================*
+ * name_heartbeat_stop()                                                      *
+ *============================================================================*/
+
+/**
+ * The name_heartbeat_stop() function tells Name Servers to stop
+ * tracking the liveness of the calling node.
+ */
+int name_heartbeat_stop(void)
+{
+	return (name_alive(0));
+}
+
 /*============================================================================*
  * name_shutdown()                                                            *
  *============================================================================*/
@@ -242,8 +897,11 @@ int name_shutdown(void)
 	/* Build operation header. */
 	message_header_build(&msg.header, NAME_EXIT);
 
-	if ((ret = kmailbox_write(server, &msg, sizeof(struct name_message))) != sizeof(struct name_message))
-		return (ret);
+	for (int i = 0; i < NAME_SERVERS_NUM; i++)
+	{
+		if ((ret = kmailbox_write(server[i], &msg, sizeof(struct name_message))) != sizeof(struct name_message))
+			return (ret);
+	}
 
 	return (0);
 }
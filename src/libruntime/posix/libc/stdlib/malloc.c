@@ -54,6 +54,391 @@ struct block
 static struct block head;
 static struct block *freep = NULL;
 
+/**
+ * @brief Free blocks with at least this many whole pages are trimmed.
+ */
+#define HEAP_TRIM_THRESHOLD 16
+
+/**
+ * @brief Heap statistics (in pages).
+ */
+static struct
+{
+	size_t npages;    /* Pages owned by the heap.           */
+	size_t nreleased; /* Pages given back to remote memory. */
+} heap = { 0, 0 };
+
+/**
+ * @brief End of the last heap expansion.
+ */
+static struct block *heap_top = NULL;
+
+/**
+ * @brief Log2 of the smallest size class (in bytes).
+ */
+#define SLAB_CLASS_SHIFT 4
+
+/**
+ * @brief Number of size classes.
+ */
+#define SLAB_CLASSES 8
+
+/**
+ * @brief Largest object that is served by slabs (in bytes).
+ */
+#define SLAB_OBJECT_MAX (1 << (SLAB_CLASS_SHIFT + SLAB_CLASSES - 1))
+
+/**
+ * @brief Size of a slab (in bytes).
+ */
+#define SLAB_SIZE PAGE_SIZE
+
+/**
+ * @brief Maximum number of slabs.
+ */
+#define SLAB_MAX 256
+
+/**
+ * @brief Maximum number of objects in a slab.
+ */
+#define SLAB_OBJECTS_MAX (SLAB_SIZE >> SLAB_CLASS_SHIFT)
+
+/**
+ * @brief Length of the free object bitmap of a slab.
+ */
+#define SLAB_BITMAP_LENGTH (SLAB_OBJECTS_MAX/32)
+
+/**
+ * @brief Number of empty slabs kept before giving them back.
+ */
+#define SLAB_EMPTY_MAX 4
+
+/**
+ * @brief Null slab.
+ */
+#define SLAB_NULL (-1)
+
+/**
+ * @brief Slab.
+ *
+ * @details Slabs carve one page of the slab area into objects of a
+ * single size class. Descriptors are kept in local memory, so that
+ * small allocations and frees never touch remote memory.
+ */
+struct slab
+{
+	int class;                           /* Size class.                */
+	int nfree;                           /* Number of free objects.    */
+	int prev;                            /* Previous slab in the list. */
+	int next;                            /* Next slab in the list.     */
+	int released;                        /* Given back?                */
+	uint32_t bitmap[SLAB_BITMAP_LENGTH]; /* Free objects (set bits).   */
+};
+
+/**
+ * @brief Slab allocator.
+ */
+static struct
+{
+	char *base;                   /* Base address of slab area.    */
+	int nslabs;                   /* Number of slabs ever carved.  */
+	int free;                     /* List of empty slabs.          */
+	int nempty;                   /* Empty slabs not given back.   */
+	int partial[SLAB_CLASSES];    /* Lists of slabs with room.     */
+	struct slab slabs[SLAB_MAX];  /* Slabs.                        */
+} slabs = { .base = NULL, };
+
+/**
+ * @brief Initializes the slab allocator.
+ *
+ * @details The slab area is reserved at once and pages are backed by
+ * remote memory on first touch, so unused slabs cost nothing.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int slab_init(void)
+{
+	/* Nothing to be done. */
+	if (slabs.base != NULL)
+		return (0);
+
+	if ((slabs.base = nanvix_vmem_reserve(SLAB_MAX*SLAB_SIZE/PAGE_SIZE)) == NULL)
+		return (-ENOMEM);
+
+	slabs.nslabs = 0;
+	slabs.free = SLAB_NULL;
+	slabs.nempty = 0;
+	for (int i = 0; i < SLAB_CLASSES; i++)
+		slabs.partial[i] = SLAB_NULL;
+
+	return (0);
+}
+
+/**
+ * @brief Asserts whether or not a pointer lies in the slab area.
+ *
+ * @param ptr Target pointer.
+ *
+ * @returns Non-zero if @p ptr lies in the slab area, and zero otherwise.
+ */
+static int slab_owns(const void *ptr)
+{
+	if (slabs.base == NULL)
+		return (0);
+
+	return (
+		((const char *)ptr >= slabs.base) &&
+		((const char *)ptr < slabs.base + SLAB_MAX*SLAB_SIZE)
+	);
+}
+
+/**
+ * @brief Returns the number of objects in a slab of a size class.
+ *
+ * @param class Target size class.
+ */
+static inline int slab_capacity(int class)
+{
+	return (SLAB_SIZE >> (SLAB_CLASS_SHIFT + class));
+}
+
+/**
+ * @brief Returns the size of a small object.
+ *
+ * @param ptr Target object.
+ */
+static size_t slab_object_size(const void *ptr)
+{
+	int i;
+
+	i = ((const char *)ptr - slabs.base)/SLAB_SIZE;
+
+	return ((size_t)1 << (SLAB_CLASS_SHIFT + slabs.slabs[i].class));
+}
+
+/**
+ * @brief Inserts a slab at the head of a list.
+ *
+ * @param list Target list.
+ * @param i    Target slab.
+ */
+static void slab_push(int *list, int i)
+{
+	slabs.slabs[i].prev = SLAB_NULL;
+	slabs.slabs[i].next = *list;
+	if (*list != SLAB_NULL)
+		slabs.slabs[*list].prev = i;
+	*list = i;
+}
+
+/**
+ * @brief Removes a slab from a list.
+ *
+ * @param list Target list.
+ * @param i    Target slab.
+ */
+static void slab_remove(int *list, int i)
+{
+	if (slabs.slabs[i].prev != SLAB_NULL)
+		slabs.slabs[slabs.slabs[i].prev].next = slabs.slabs[i].next;
+	else
+		*list = slabs.slabs[i].next;
+
+	if (slabs.slabs[i].next != SLAB_NULL)
+		slabs.slabs[slabs.slabs[i].next].prev = slabs.slabs[i].prev;
+}
+
+/**
+ * @brief Allocates a small object.
+ *
+ * @param size Number of bytes to allocate.
+ *
+ * @returns Upon successful completion, a pointer to the allocated
+ * object is returned. Upon failure, a null pointer is returned
+ * instead.
+ */
+static void *slab_alloc(size_t size)
+{
+	int i;           /* Slab.         */
+	int j;           /* Bitmap word.  */
+	int k;           /* Bitmap bit.   */
+	int class;       /* Size class.   */
+	struct slab *sp; /* Working slab. */
+
+	if (slab_init() < 0)
+		return (NULL);
+
+	for (class = 0; (1U << (SLAB_CLASS_SHIFT + class)) < size; class++)
+		/* noop */;
+
+	/* Carve a new slab. */
+	if ((i = slabs.partial[class]) == SLAB_NULL)
+	{
+		if ((i = slabs.free) != SLAB_NULL)
+		{
+			slab_remove(&slabs.free, i);
+			if (slabs.slabs[i].released)
+				heap.nreleased--;
+			else
+				slabs.nempty--;
+		}
+		else if (slabs.nslabs < SLAB_MAX)
+		{
+			i = slabs.nslabs++;
+			heap.npages += SLAB_SIZE/PAGE_SIZE;
+		}
+		else
+			return (NULL);
+
+		sp = &slabs.slabs[i];
+		sp->class = class;
+		sp->released = 0;
+		sp->nfree = slab_capacity(class);
+		for (j = 0; j < SLAB_BITMAP_LENGTH; j++)
+			sp->bitmap[j] = 0;
+		for (j = 0; j < sp->nfree; j++)
+			sp->bitmap[j/32] |= (1U << (j%32));
+
+		slab_push(&slabs.partial[class], i);
+	}
+
+	sp = &slabs.slabs[i];
+
+	/* Take the first free object. */
+	for (j = 0; sp->bitmap[j] == 0; j++)
+		/* noop */;
+	for (k = 0; !(sp->bitmap[j] & (1U << k)); k++)
+		/* noop */;
+	sp->bitmap[j] &= ~(1U << k);
+
+	/* Slab is now full. */
+	if (--sp->nfree == 0)
+		slab_remove(&slabs.partial[class], i);
+
+	return (
+		slabs.base + i*SLAB_SIZE +
+		((j*32 + k) << (SLAB_CLASS_SHIFT + class))
+	);
+}
+
+/**
+ * @brief Frees a small object.
+ *
+ * @param ptr Target object.
+ */
+static void slab_free(void *ptr)
+{
+	int i;           /* Slab.         */
+	int obj;         /* Object.       */
+	size_t off;      /* Offset.       */
+	struct slab *sp; /* Working slab. */
+
+	off = (char *)ptr - slabs.base;
+	i = off/SLAB_SIZE;
+	sp = &slabs.slabs[i];
+	obj = (off%SLAB_SIZE) >> (SLAB_CLASS_SHIFT + sp->class);
+
+	/* Double free. */
+	uassert(!(sp->bitmap[obj/32] & (1U << (obj%32))));
+
+	sp->bitmap[obj/32] |= (1U << (obj%32));
+
+	/* Slab has room again. */
+	if (++sp->nfree == 1)
+		slab_push(&slabs.partial[sp->class], i);
+
+	/* Slab is now empty. */
+	if (sp->nfree == slab_capacity(sp->class))
+	{
+		slab_remove(&slabs.partial[sp->class], i);
+		slab_push(&slabs.free, i);
+
+		/* Keep a few empty slabs around, and give back the others. */
+		if (slabs.nempty < SLAB_EMPTY_MAX)
+			slabs.nempty++;
+		else
+		{
+			nanvix_vmem_advise(slabs.base + i*SLAB_SIZE, SLAB_SIZE, RMEM_ADVICE_DONTNEED);
+			sp->released = 1;
+			heap.nreleased += SLAB_SIZE/PAGE_SIZE;
+		}
+	}
+}
+
+/**
+ * @brief Computes the whole pages in the data area of a free block.
+ *
+ * @param bp    Target block.
+ * @param start Store location for the first page (may be NULL).
+ *
+ * @returns The number of whole pages in the data area of @p bp.
+ */
+static size_t heap_interior(struct block *bp, vaddr_t *start)
+{
+	vaddr_t first;
+	vaddr_t end;
+
+	first = TRUNCATE((vaddr_t)(bp + 1), PAGE_SIZE);
+	end = ((vaddr_t)(bp + bp->nblocks)) & PAGE_MASK;
+
+	if (start != NULL)
+		*start = first;
+
+	return ((end > first) ? (end - first)/PAGE_SIZE : 0);
+}
+
+/**
+ * @brief Computes the pages of a free block that are given back.
+ *
+ * @param bp Target block.
+ *
+ * @returns The number of pages of @\p bp that are given back to remote
+ * memory.
+ */
+static size_t heap_released(struct block *bp)
+{
+	size_t n;
+
+	n = heap_interior(bp, NULL);
+
+	return ((n >= HEAP_TRIM_THRESHOLD) ? n : 0);
+}
+
+/**
+ * @brief Gives the whole pages of a free block back to remote memory.
+ *
+ * @param bp        Target block.
+ * @param lo        Pages below this address are already given back.
+ * @param hi        Pages from this address on are already given back.
+ * @param nreleased Number of pages of @p bp that are already given back.
+ */
+static void heap_trim(struct block *bp, vaddr_t lo, vaddr_t hi, size_t nreleased)
+{
+	size_t n;
+	vaddr_t start;
+	vaddr_t end;
+
+	/* Too small to be worth it. */
+	if (heap_released(bp) == 0)
+		return;
+
+	n = heap_interior(bp, &start);
+	end = start + n*PAGE_SIZE;
+
+	if (start < lo)
+		start = lo;
+	if (end > hi)
+		end = hi;
+
+	/* Best effort: pages that are not given back are just kept. */
+	if (end > start)
+		nanvix_vmem_advise((void *)start, end - start, RMEM_ADVICE_DONTNEED);
+
+	heap.nreleased += n - nreleased;
+}
+
+
 /**
  * @brief Frees allocated memory.
  *
@@ -61,13 +446,24 @@ static struct block *freep = NULL;
  */
 void nanvix_free(void *ptr)
 {
-	struct block *p;  /* Working block.     */
-	struct block *bp; /* Block being freed. */
+	struct block *p;  /* Working block.            */
+	struct block *bp; /* Block being freed.        */
+	vaddr_t lo;       /* Start of trimming.        */
+	vaddr_t hi;       /* End of trimming.          */
+	size_t n;         /* Pages of a neighbour.     */
+	size_t nreleased; /* Pages already given back. */
 
 	/* Nothing to be done. */
 	if (ptr == NULL)
 		return;
 
+	/* Small object. */
+	if (slab_owns(ptr))
+	{
+		slab_free(ptr);
+		return;
+	}
+
 	bp = (struct block *)ptr - 1;
 
 	/* Look for insertion point. */
@@ -78,9 +474,20 @@ void nanvix_free(void *ptr)
 			break;
 	}
 
+	lo = 0;
+	hi = (vaddr_t)-1;
+	nreleased = 0;
+
 	/* Merge with upper block. */
 	if (bp + bp->nblocks == p->nextp)
 	{
+		/* Upper pages are already given back. */
+		if ((n = heap_released(p->nextp)) > 0)
+		{
+			heap_interior(p->nextp, &hi);
+			nreleased += n;
+		}
+
 		bp->nblocks += p->nextp->nblocks;
 		bp->nextp = p->nextp->nextp;
 	}
@@ -90,28 +497,40 @@ void nanvix_free(void *ptr)
 	/* Merge with lower block. */
 	if (p + p->nblocks == bp)
 	{
+		/* Lower pages are already given back. */
+		if ((n = heap_released(p)) > 0)
+		{
+			heap_interior(p, &lo);
+			lo += n*PAGE_SIZE;
+			nreleased += n;
+		}
+
 		p->nblocks += bp->nblocks;
 		p->nextp = bp->nextp;
+		bp = p;
 	}
 	else
 		p->nextp = bp;
 
-
 	freep = p;
+
+	heap_trim(bp, lo, hi, nreleased);
 }
 
 /**
- * @brief Expands the heap.
+ * @brief Reserves a heap expansion.
  *
- * @details Expands the heap by @p nblocks.
+ * @details Reserves at least @p nblocks, in whole cache lines of
+ * remote memory, and hands all of them to a single block. The block
+ * is not put on the free list.
  *
  * @param nblocks Number of blocks to expand.
  *
- * @returns Upon successful completion a pointed to the expansion is returned.
- *          Upon failure, a null pointed is returned instead and errno is set
- *          to indicate the error.
+ * @returns Upon successful completion, the block that spans the
+ * expansion is returned. Upon failure, a null pointer is returned
+ * instead.
  */
-static void *expand(unsigned nblocks)
+static struct block *heap_reserve(unsigned nblocks)
 {
 	struct block *p;
 	size_t n;
@@ -120,38 +539,65 @@ static void *expand(unsigned nblocks)
 	if (nblocks < NALLOC)
 		nblocks = NALLOC;
 
-	n = TRUNCATE(nblocks*BLOCK_SIZE, PAGE_SIZE)/PAGE_SIZE;
+	/*
+	 * Use up the whole reservation, so that
+	 * the next one may start right above it.
+	 */
+	n = TRUNCATE(nblocks*BLOCK_SIZE, RMEM_CACHE_BLOCK_SIZE*PAGE_SIZE)/PAGE_SIZE;
+	nblocks = (n*PAGE_SIZE)/BLOCK_SIZE;
 
-	/* Request more memory to the kernel. */
-	if ((p = nanvix_vmem_alloc(n)) == NULL)
+	/*
+	 * Request more memory to the kernel. Pages
+	 * are backed by remote memory on first touch.
+	 */
+	if ((p = nanvix_vmem_reserve(n)) == NULL)
 		return (NULL);
 
+	heap.npages += n;
+	heap_top = p + nblocks;
+
 	p->nblocks = nblocks;
+
+	return (p);
+}
+
+/**
+ * @brief Expands the heap.
+ *
+ * @details Expands the heap by at least @p nblocks.
+ *
+ * @param nblocks Number of blocks to expand.
+ *
+ * @returns Upon successful completion a pointed to the expansion is returned.
+ *          Upon failure, a null pointed is returned instead and errno is set
+ *          to indicate the error.
+ */
+static void *expand(unsigned nblocks)
+{
+	struct block *p;
+
+	if ((p = heap_reserve(nblocks)) == NULL)
+		return (NULL);
+
 	nanvix_free(p + 1);
 
 	return (freep);
 }
 
 /**
- * @brief Allocates memory.
+ * @brief Allocates a block from the free list.
  *
  * @param size Number of bytes to allocate.
  *
- * @returns Upon successful completion with size not equal to 0, nanvix_malloc()
- *          returns a pointer to the allocated space. If size is 0, either a
- *          null pointer or a unique pointer that can be successfully passed to
- *          nanvix_free() is returned. Otherwise, it returns a null pointer and set
- *          errno to indicate the error.
+ * @returns Upon successful completion, a pointer to the allocated
+ * block is returned. Upon failure, a null pointer is returned instead.
  */
-void *nanvix_malloc(size_t size)
+static void *heap_alloc(size_t size)
 {
 	struct block *p;     /* Working block.            */
 	struct block *prevp; /* Previous working block.   */
 	unsigned nblocks;    /* Request size (in blocks). */
-
-	/* Nothing to be done. */
-	if (size == 0)
-		return (NULL);
+	size_t nreleased;    /* Pages given back.         */
 
 	nblocks = (size + (BLOCK_SIZE - 1))/BLOCK_SIZE + 1;
 
@@ -168,6 +614,8 @@ void *nanvix_malloc(size_t size)
 		/* Found. */
 		if (p->nblocks >= nblocks)
 		{
+			nreleased = heap_released(p);
+
 			/* Exact. */
 			if (p->nblocks == nblocks)
 				prevp->nextp = p->nextp;
@@ -176,10 +624,14 @@ void *nanvix_malloc(size_t size)
 			else
 			{
 				p->nblocks -= nblocks;
+				nreleased -= heap_released(p);
 				p += p->nblocks;
 				p->nblocks = nblocks;
 			}
 
+			/* Pages handed out are backed again on first touch. */
+			heap.nreleased -= nreleased;
+
 			freep = prevp;
 
 			return (p + 1);
@@ -197,6 +649,241 @@ void *nanvix_malloc(size_t size)
 	return (NULL);
 }
 
+/**
+ * @brief Allocates memory.
+ *
+ * @param size Number of bytes to allocate.
+ *
+ * @returns Upon successful completion with size not equal to 0, nanvix_malloc()
+ *          returns a pointer to the allocated space. If size is 0, either a
+ *          null pointer or a unique pointer that can be successfully passed to
+ *          nanvix_free() is returned. Otherwise, it returns a null pointer and set
+ *          errno to indicate the error.
+ */
+void *nanvix_malloc(size_t size)
+{
+	void *ptr;
+
+	/* Nothing to be done. */
+	if (size == 0)
+		return (NULL);
+
+	/* Small object. */
+	if (size <= SLAB_OBJECT_MAX)
+	{
+		if ((ptr = slab_alloc(size)) != NULL)
+			return (ptr);
+	}
+
+	return (heap_alloc(size));
+}
+
+/**
+ * @brief Objects of at least this many bytes are moved by remapping.
+ */
+#define HEAP_REMAP_MIN (2*PAGE_SIZE)
+
+/**
+ * @brief Shrinks an allocated block in place.
+ *
+ * @param bp      Target block.
+ * @param nblocks New size (in blocks).
+ */
+static void heap_shrink(struct block *bp, unsigned nblocks)
+{
+	struct block *tail;
+
+	/* Nothing to be done. */
+	if (bp->nblocks <= nblocks)
+		return;
+
+	tail = bp + nblocks;
+	tail->nblocks = bp->nblocks - nblocks;
+	bp->nblocks = nblocks;
+
+	nanvix_free(tail + 1);
+}
+
+/**
+ * @brief Grows an allocated block in place.
+ *
+ * @details The block is grown into the free block right above it.
+ *
+ * @param bp      Target block.
+ * @param nblocks New size (in blocks).
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int heap_grow(struct block *bp, unsigned nblocks)
+{
+	struct block *p;     /* Upper block.          */
+	struct block *prevp; /* Block before upper.   */
+	struct block *q;     /* Remainder of upper.   */
+	unsigned extra;      /* Missing blocks.       */
+	size_t nreleased;    /* Pages given back.     */
+
+	/* Empty free list. */
+	if (freep == NULL)
+		return (-ENOMEM);
+
+	p = bp + bp->nblocks;
+	extra = nblocks - bp->nblocks;
+
+	/* Look for upper block. */
+	for (prevp = freep; prevp->nextp != p; prevp = prevp->nextp)
+	{
+		/* Not free. */
+		if (prevp->nextp == freep)
+			return (-ENOMEM);
+	}
+
+	/* Too small. */
+	if (p->nblocks < extra)
+		return (-ENOMEM);
+
+	nreleased = heap_released(p);
+
+	/* Exact. */
+	if (p->nblocks == extra)
+		prevp->nextp = p->nextp;
+
+	/* Split block. */
+	else
+	{
+		q = p + extra;
+		q->nblocks = p->nblocks - extra;
+		q->nextp = p->nextp;
+		prevp->nextp = q;
+		nreleased -= heap_released(q);
+	}
+
+	/* Pages handed out are backed again on first touch. */
+	heap.nreleased -= nreleased;
+
+	bp->nblocks = nblocks;
+	freep = prevp;
+
+	return (0);
+}
+
+/**
+ * @brief Computes how much the heap should expand for a block to grow.
+ *
+ * @details A block may grow into an expansion only if it lies at the
+ * end of the heap, or if the free block right above it does. In the
+ * latter case, the free block already covers part of the growth.
+ *
+ * @param bp      Target block.
+ * @param nblocks New size (in blocks).
+ *
+ * @returns The number of blocks that the heap should expand by, so
+ * that @p bp grows in place. If it cannot grow in place, zero is
+ * returned instead.
+ */
+static unsigned heap_shortfall(struct block *bp, unsigned nblocks)
+{
+	struct block *p;     /* Upper block.        */
+	struct block *prevp; /* Block before upper. */
+	unsigned extra;      /* Missing blocks.     */
+
+	p = bp + bp->nblocks;
+	extra = nblocks - bp->nblocks;
+
+	/* Block lies at the end of the heap. */
+	if (p == heap_top)
+		return (extra);
+
+	/* Empty free list. */
+	if (freep == NULL)
+		return (0);
+
+	/* Look for upper block. */
+	for (prevp = freep; prevp->nextp != p; prevp = prevp->nextp)
+	{
+		/* Not free. */
+		if (prevp->nextp == freep)
+			return (0);
+	}
+
+	/* Upper block does not lie at the end of the heap. */
+	if ((p + p->nblocks) != heap_top)
+		return (0);
+
+	return ((p->nblocks < extra) ? extra - p->nblocks : 0);
+}
+
+/**
+ * @brief Allocates a block at a given offset from an alignment.
+ *
+ * @param size   Number of bytes to allocate.
+ * @param align  Alignment (power of two, and at least BLOCK_SIZE).
+ * @param offset Offset of data from @p align.
+ *
+ * @returns Upon successful completion, a pointer to the allocated
+ * block is returned. Upon failure, a null pointer is returned instead.
+ */
+static void *heap_alloc_aligned(size_t size, size_t align, vaddr_t offset)
+{
+	struct block *p;  /* Working block.             */
+	struct block *bp; /* Allocated block.           */
+	unsigned nblocks; /* Request size (in blocks).  */
+	unsigned k;       /* Blocks to skip.            */
+
+	if ((p = heap_alloc(size + align)) == NULL)
+		return (NULL);
+	p--;
+
+	nblocks = (size + (BLOCK_SIZE - 1))/BLOCK_SIZE + 1;
+	k = ((offset - ((vaddr_t)(p + 1))) & (align - 1))/BLOCK_SIZE;
+
+	/* Give back leading blocks. */
+	if (k > 0)
+	{
+		bp = p + k;
+		bp->nblocks = p->nblocks - k;
+		p->nblocks = k;
+		nanvix_free(p + 1);
+	}
+	else
+		bp = p;
+
+	/* Give back trailing blocks. */
+	heap_shrink(bp, nblocks);
+
+	return (bp + 1);
+}
+
+/**
+ * @brief Moves an object.
+ *
+ * @details Whole pages of large objects are moved by remapping them.
+ *
+ * @param dst Target object.
+ * @param src Source object.
+ * @param n   Number of bytes to move.
+ */
+static void heap_move(void *dst, void *src, size_t n)
+{
+	size_t lead;   /* Bytes before first whole page. */
+	size_t middle; /* Bytes in whole pages.          */
+
+	/* Pages do not line up. */
+	if ((n < HEAP_REMAP_MIN) || ((((vaddr_t) dst) - ((vaddr_t) src)) & (PAGE_SIZE - 1)))
+	{
+		umemcpy(dst, src, n);
+		return;
+	}
+
+	lead = TRUNCATE((vaddr_t) src, PAGE_SIZE) - (vaddr_t) src;
+	middle = ((((vaddr_t) src) + n) & PAGE_MASK) - (((vaddr_t) src) + lead);
+
+	umemcpy(dst, src, lead);
+	if (nanvix_vmem_remap((char *) dst + lead, (char *) src + lead, middle) < 0)
+		umemcpy((char *) dst + lead, (char *) src + lead, middle);
+	umemcpy((char *) dst + lead + middle, (char *) src + lead + middle, n - lead - middle);
+}
+
 /**
  * @brief Reallocates a memory chunk.
  *
@@ -206,11 +893,21 @@ void *nanvix_malloc(size_t size)
  * @returns Upon successful completion, nanvix_realloc() returns a pointer to the
  *           allocated space. Upon failure, a null pointer is returned instead.
  *
- * @todo Check if we can simply expand.
+ * @details Objects are shrunk in place, and grown in place into the
+ * free block right above them or, at the end of the heap, into a heap
+ * expansion that starts right at its end. Otherwise, the
+ * object is moved, and whole pages of large objects are remapped
+ * rather than copied.
  */
 void *nanvix_realloc(void *ptr, size_t size)
 {
-	void *newptr;
+	void *newptr;      /* New object.               */
+	size_t oldsize;    /* Size of old object.       */
+	unsigned nblocks;  /* Request size (in blocks). */
+	unsigned extra;    /* Heap expansion.           */
+	struct block *bp;  /* Old block.                */
+	struct block *p;   /* Heap expansion.           */
+	struct block *top; /* Old end of the heap.      */
 
 	/* Nothing to be done. */
 	if (size == 0)
@@ -219,11 +916,192 @@ void *nanvix_realloc(void *ptr, size_t size)
 		return (NULL);
 	}
 
-	newptr = nanvix_malloc(size);
-	if (ptr != NULL)
-		umemcpy(newptr, ptr, size);
+	if (ptr == NULL)
+		return (nanvix_malloc(size));
 
+	/* Small object. */
+	if (slab_owns(ptr))
+	{
+		oldsize = slab_object_size(ptr);
+
+		/* Shrink in place. */
+		if (size <= oldsize)
+			return (ptr);
+	}
+
+	/* Large object. */
+	else
+	{
+		bp = (struct block *)ptr - 1;
+		oldsize = (bp->nblocks - 1)*BLOCK_SIZE;
+		nblocks = (size + (BLOCK_SIZE - 1))/BLOCK_SIZE + 1;
+
+		/* Shrink in place. */
+		if (nblocks <= bp->nblocks)
+		{
+			heap_shrink(bp, nblocks);
+			return (ptr);
+		}
+
+		/* Grow in place. */
+		if (heap_grow(bp, nblocks) == 0)
+			return (ptr);
+
+		/*
+		 * Grow in place, into a heap expansion. The expansion
+		 * is only of use if it starts right at the end of the
+		 * heap. Otherwise, it is kept for later requests.
+		 */
+		if ((extra = heap_shortfall(bp, nblocks)) > 0)
+		{
+			top = heap_top;
+
+			if ((p = heap_reserve(extra)) != NULL)
+			{
+				nanvix_free(p + 1);
+
+				if ((p == top) && (heap_grow(bp, nblocks) == 0))
+					return (ptr);
+			}
+		}
+	}
+
+	/*
+	 * Large objects share the page offset of the old
+	 * one, so that whole pages may be remapped.
+	 */
+	newptr = (size >= HEAP_REMAP_MIN) ?
+		heap_alloc_aligned(size, PAGE_SIZE, (vaddr_t) ptr) : nanvix_malloc(size);
+
+	if (newptr == NULL)
+		return (NULL);
+
+	heap_move(newptr, ptr, (oldsize < size) ? oldsize : size);
 	nanvix_free(ptr);
 
 	return (newptr);
 }
+
+/**
+ * @brief Allocates zero-initialized memory.
+ *
+ * @param nmemb Number of elements.
+ * @param size  Size of an element.
+ *
+ * @returns Upon successful completion, nanvix_calloc() returns a pointer to
+ *          the allocated space. Otherwise, it returns a null pointer and sets
+ *          errno to indicate the error.
+ *
+ * @details Remote pages that were never touched, such as those of fresh
+ * heap expansions or of trimmed free blocks, already read as zeros and
+ * are not written, so large arrays cost nothing until touched.
+ */
+void *nanvix_calloc(size_t nmemb, size_t size)
+{
+	void *ptr;
+	size_t n;
+
+	/* Overflow. */
+	if ((size != 0) && (nmemb > ((size_t) -1)/size))
+	{
+		errno = ENOMEM;
+		return (NULL);
+	}
+
+	n = nmemb*size;
+
+	if ((ptr = nanvix_malloc(n)) == NULL)
+		return (NULL);
+
+	/* Small object. */
+	if (slab_owns(ptr) || (n < PAGE_SIZE))
+		umemset(ptr, 0, n);
+	else if (nanvix_vmem_zero(ptr, n) < 0)
+		umemset(ptr, 0, n);
+
+	return (ptr);
+}
+
+/**
+ * @brief Allocates aligned memory.
+ *
+ * @param alignment Alignment (power of two).
+ * @param size      Number of bytes to allocate.
+ *
+ * @returns Upon successful completion, nanvix_memalign() returns a pointer to
+ *          the allocated space, aligned to @p alignment. Otherwise, it returns
+ *          a null pointer and sets errno to indicate the error.
+ *
+ * @details Small objects are naturally aligned to their size class, so
+ * they are served from slabs whenever possible.
+ */
+void *nanvix_memalign(size_t alignment, size_t size)
+{
+	void *ptr;
+
+	/* Bad alignment. */
+	if ((alignment == 0) || ((alignment & (alignment - 1)) != 0))
+	{
+		errno = EINVAL;
+		return (NULL);
+	}
+
+	/* Nothing to be done. */
+	if (size == 0)
+		return (NULL);
+
+	/* Naturally aligned. */
+	if (alignment <= BLOCK_SIZE)
+		return (nanvix_malloc(size));
+
+	/* Small object. */
+	if ((size <= SLAB_OBJECT_MAX) && (alignment <= SLAB_OBJECT_MAX))
+	{
+		if ((ptr = slab_alloc((size < alignment) ? alignment : size)) != NULL)
+			return (ptr);
+	}
+
+	return (heap_alloc_aligned(size, alignment, 0));
+}
+
+/**
+ * @brief Allocates aligned memory.
+ *
+ * @param alignment Alignment (power of two).
+ * @param size      Number of bytes to allocate (multiple of @p alignment).
+ *
+ * @returns Upon successful completion, nanvix_aligned_alloc() returns a
+ *          pointer to the allocated space. Otherwise, it returns a null
+ *          pointer and sets errno to indicate the error.
+ */
+void *nanvix_aligned_alloc(size_t alignment, size_t size)
+{
+	/* Bad size. */
+	if ((alignment != 0) && ((size & (alignment - 1)) != 0))
+	{
+		errno = EINVAL;
+		return (NULL);
+	}
+
+	return (nanvix_memalign(alignment, size));
+}
+
+/**
+ * @brief Reports heap usage of remote memory.
+ *
+ * @param retained Store location for the number of bytes that the
+ *                 heap keeps (may be NULL).
+ * @param returned Store location for the number of bytes that the
+ *                 heap gave back to remote memory (may be NULL).
+ *
+ * @details Bytes in use or kept in the free lists count as retained,
+ * even if they were never touched. Whole pages of large free blocks
+ * and of surplus empty slabs count as returned.
+ */
+void nanvix_malloc_stats(size_t *retained, size_t *returned)
+{
+	if (retained != NULL)
+		*retained = (heap.npages - heap.nreleased)*PAGE_SIZE;
+	if (returned != NULL)
+		*returned = heap.nreleased*PAGE_SIZE;
+}
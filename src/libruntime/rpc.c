@@ -0,0 +1,638 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2020 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <nanvix/runtime/inbox.h>
+#include <nanvix/runtime/rpc.h>
+#include <nanvix/sys/mailbox.h>
+#include <nanvix/sys/noc.h>
+#include <nanvix/ulib.h>
+#include <posix/errno.h>
+#include <posix/stdint.h>
+
+/**
+ * @brief Length of a message buffer (in double words).
+ */
+#define NANVIX_RPC_BUFFER_LENGTH \
+	((NANVIX_MAILBOX_MESSAGE_SIZE + sizeof(uint64_t) - 1)/sizeof(uint64_t))
+
+/**
+ * @brief Operation of messages that wake up dispatch threads.
+ *
+ * It lies out of the range of handlers, so it never clashes with
+ * requests of the server.
+ */
+#define NANVIX_RPC_WAKEUP NANVIX_RPC_OPCODES_MAX
+
+/*============================================================================*
+ * nanvix_rpc_server_init()                                                   *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_server_init() function initializes the RPC server
+ * pointed to by @p server, so that it dispatches requests of @p size
+ * bytes that arrive at @p inbox. No handlers are registered.
+ */
+int nanvix_rpc_server_init(
+	struct nanvix_rpc_server *server,
+	int inbox,
+	int port,
+	size_t size,
+	int flags
+)
+{
+	/* Invalid server. */
+	if (server == NULL)
+		return (-EINVAL);
+
+	/* Invalid message size. */
+	if ((size < sizeof(message_header)) || (size > NANVIX_MAILBOX_MESSAGE_SIZE))
+		return (-EINVAL);
+
+	server->inbox = inbox;
+	server->port = port;
+	server->size = size;
+	server->flags = flags;
+	server->nthreads = 0;
+	server->shutdown = 0;
+	server->nblocked = 0;
+	server->clock = 0;
+
+	for (int i = 0; i < NANVIX_RPC_OPCODES_MAX; i++)
+	{
+		server->handlers[i] = NULL;
+		server->stats[i].count = 0;
+		server->stats[i].cycles = 0;
+		server->stats[i].max = 0;
+	}
+
+	for (int i = 0; i < NANVIX_RPC_CHANNELS_MAX; i++)
+		server->channels[i].nodenum = -1;
+
+	nanvix_semaphore_init(&server->lock, 1);
+	nanvix_semaphore_init(&server->channels_lock, 1);
+	nanvix_semaphore_init(&server->state_lock, 1);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rpc_server_cleanup()                                                *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_server_cleanup() function closes all reply channels
+ * cached by the RPC server pointed to by @p server.
+ */
+int nanvix_rpc_server_cleanup(struct nanvix_rpc_server *server)
+{
+	/* Invalid server. */
+	if (server == NULL)
+		return (-EINVAL);
+
+	for (int i = 0; i < NANVIX_RPC_CHANNELS_MAX; i++)
+	{
+		if (server->channels[i].nodenum == -1)
+			continue;
+
+		uassert(kmailbox_close(server->channels[i].outbox) == 0);
+		server->channels[i].nodenum = -1;
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rpc_register()                                                      *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_register() function registers @p handler to handle
+ * requests of operation @p opcode in the RPC server pointed to by @p
+ * server. A previous handler of the operation, if any, is replaced.
+ */
+int nanvix_rpc_register(
+	struct nanvix_rpc_server *server,
+	int opcode,
+	nanvix_rpc_handler_t handler
+)
+{
+	/* Invalid server. */
+	if (server == NULL)
+		return (-EINVAL);
+
+	/* Invalid operation. */
+	if ((opcode < 0) || (opcode >= NANVIX_RPC_OPCODES_MAX))
+		return (-EINVAL);
+
+	server->handlers[opcode] = handler;
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rpc_channel()                                                       *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_channel() function gets an output mailbox to the port
+ * @p port of the NoC node @p nodenum. Output mailboxes are cached, so
+ * that replies to frequent clients skip open and close. When the cache
+ * is full, the least recently used mailbox is closed.
+ */
+int nanvix_rpc_channel(struct nanvix_rpc_server *server, int nodenum, int port)
+{
+	int i;
+	int victim;
+	int outbox;
+
+	/* Invalid server. */
+	if (server == NULL)
+		return (-EINVAL);
+
+	nanvix_semaphore_down(&server->channels_lock);
+
+		server->clock++;
+
+		/* Search for a cached channel. */
+		victim = 0;
+		for (i = 0; i < NANVIX_RPC_CHANNELS_MAX; i++)
+		{
+			/* Found. */
+			if ((server->channels[i].nodenum == nodenum) && (server->channels[i].port == port))
+				break;
+
+			/* Prefer free channels, then older ones. */
+			if (server->channels[victim].nodenum == -1)
+				continue;
+			if ((server->channels[i].nodenum == -1) || (server->channels[i].age < server->channels[victim].age))
+				victim = i;
+		}
+
+		/* Cache miss. */
+		if (i == NANVIX_RPC_CHANNELS_MAX)
+		{
+			if ((outbox = kmailbox_open(nodenum, port)) < 0)
+			{
+				nanvix_semaphore_up(&server->channels_lock);
+				return (outbox);
+			}
+
+			i = victim;
+
+			/* Evict. */
+			if (server->channels[i].nodenum != -1)
+				uassert(kmailbox_close(server->channels[i].outbox) == 0);
+
+			server->channels[i].nodenum = nodenum;
+			server->channels[i].port = port;
+			server->channels[i].outbox = outbox;
+		}
+
+		server->channels[i].age = server->clock;
+		outbox = server->channels[i].outbox;
+
+	nanvix_semaphore_up(&server->channels_lock);
+
+	return (outbox);
+}
+
+/*============================================================================*
+ * nanvix_rpc_reply()                                                         *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_reply() function sends @p response to the port @p
+ * port of the NoC node @p nodenum, through a cached reply channel.
+ * This is intended for replies that are deferred by request handlers.
+ */
+int nanvix_rpc_reply(
+	struct nanvix_rpc_server *server,
+	int nodenum,
+	int port,
+	const void *response
+)
+{
+	int ret;
+	int outbox;
+
+	/* Invalid server. */
+	if (server == NULL)
+		return (-EINVAL);
+
+	/* Invalid response. */
+	if (response == NULL)
+		return (-EINVAL);
+
+	if ((outbox = nanvix_rpc_channel(server, nodenum, port)) < 0)
+		return (outbox);
+
+	if ((ret = kmailbox_write(outbox, response, server->size)) != (ssize_t) server->size)
+		return ((ret < 0) ? ret : -EIO);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rpc_dispatch()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Serializes handlers of a server.
+ *
+ * @param server Target server.
+ */
+static inline void nanvix_rpc_lock(struct nanvix_rpc_server *server)
+{
+	if (!(server->flags & NANVIX_RPC_CONCURRENT))
+		nanvix_semaphore_down(&server->lock);
+}
+
+/**
+ * @brief Releases handlers of a server.
+ *
+ * @param server Target server.
+ */
+static inline void nanvix_rpc_unlock(struct nanvix_rpc_server *server)
+{
+	if (!(server->flags & NANVIX_RPC_CONCURRENT))
+		nanvix_semaphore_up(&server->lock);
+}
+
+/**
+ * @brief Wakes up dispatch threads that are blocked in the input mailbox.
+ *
+ * @param server Target server.
+ * @param n      Number of blocked threads.
+ *
+ * @note Handlers must be released, since the input mailbox may buffer
+ * a single message, and blocked threads may have to read some requests
+ * before they get to a wakeup.
+ */
+static void nanvix_rpc_wakeup(struct nanvix_rpc_server *server, int n)
+{
+	int outbox;
+	message_header *header;
+	uint64_t wakeup[NANVIX_RPC_BUFFER_LENGTH];
+
+	/* No blocked thread. */
+	if (n == 0)
+		return;
+
+	/*
+	 * Dispatch threads have no standard mailbox,
+	 * so the header is built here.
+	 */
+	umemset(wakeup, 0, sizeof(wakeup));
+	header = (message_header *) wakeup;
+	header->source = knode_get_num();
+	header->opcode = NANVIX_RPC_WAKEUP;
+	header->magic = MESSAGE_MAGIC;
+
+	uassert((outbox = kmailbox_open(knode_get_num(), server->port)) >= 0);
+
+	for (int i = 0; i < n; i++)
+		uassert(kmailbox_write(outbox, wakeup, server->size) == (ssize_t) server->size);
+
+	uassert(kmailbox_close(outbox) == 0);
+}
+
+/**
+ * @brief Asserts whether a message wakes up dispatch threads.
+ *
+ * @param header Header of the message.
+ *
+ * @returns Non-zero if the message wakes up dispatch threads, and zero
+ * otherwise.
+ */
+static inline int nanvix_rpc_is_wakeup(const message_header *header)
+{
+	return (
+		(header->opcode == NANVIX_RPC_WAKEUP) &&
+		(header->source == knode_get_num())   &&
+		(header->magic == MESSAGE_MAGIC)
+	);
+}
+
+/**
+ * @brief Asserts whether a server is shut down.
+ *
+ * @param server Target server.
+ *
+ * @returns Non-zero if the server is shut down, and zero otherwise.
+ */
+static int nanvix_rpc_stopped(struct nanvix_rpc_server *server)
+{
+	int stop;
+
+	nanvix_semaphore_down(&server->state_lock);
+		stop = server->shutdown;
+	nanvix_semaphore_up(&server->state_lock);
+
+	return (stop);
+}
+
+/**
+ * @brief Shuts down a server.
+ *
+ * @param server Target server.
+ *
+ * @returns The number of dispatch threads that should be woken up.
+ */
+static int nanvix_rpc_stop(struct nanvix_rpc_server *server)
+{
+	int n;
+
+	nanvix_semaphore_down(&server->state_lock);
+
+		/* Threads were woken up by an earlier shutdown. */
+		n = (server->shutdown) ? 0 : server->nblocked;
+		server->shutdown = 1;
+
+	nanvix_semaphore_up(&server->state_lock);
+
+	return (n);
+}
+
+/**
+ * @brief Reads a request of a server.
+ *
+ * @param server  Target server.
+ * @param request Target buffer for the request.
+ *
+ * @returns Zero if a request was read, and non-zero if the server is
+ * shut down instead.
+ *
+ * @details Once the server is shut down, threads that are blocked in
+ * the input mailbox drop requests until they read a wakeup, so that no
+ * wakeup is left over in the mailbox.
+ */
+static int nanvix_rpc_read(struct nanvix_rpc_server *server, void *request)
+{
+	int stop;
+	int wakeup;
+
+	nanvix_semaphore_down(&server->state_lock);
+
+		if (server->shutdown)
+		{
+			nanvix_semaphore_up(&server->state_lock);
+			return (1);
+		}
+
+		server->nblocked++;
+
+	nanvix_semaphore_up(&server->state_lock);
+
+	do
+	{
+		uassert(
+			kmailbox_read(
+				server->inbox,
+				request,
+				server->size
+			) == (ssize_t) server->size
+		);
+
+		wakeup = nanvix_rpc_is_wakeup(request);
+
+		nanvix_semaphore_down(&server->state_lock);
+
+			stop = server->shutdown;
+			if (!stop || wakeup)
+				server->nblocked--;
+
+		nanvix_semaphore_up(&server->state_lock);
+	} while (stop && !wakeup);
+
+	return (stop);
+}
+
+/**
+ * @brief Accounts the service time of a request.
+ *
+ * @param server Target server.
+ * @param opcode Operation of the request.
+ * @param cycles Service time.
+ */
+static void nanvix_rpc_account(struct nanvix_rpc_server *server, int opcode, uint64_t cycles)
+{
+	nanvix_semaphore_down(&server->state_lock);
+
+		server->stats[opcode].count++;
+		server->stats[opcode].cycles += cycles;
+		if (cycles > server->stats[opcode].max)
+			server->stats[opcode].max = cycles;
+
+	nanvix_semaphore_up(&server->state_lock);
+}
+
+/**
+ * @brief Dispatches requests of an RPC server.
+ *
+ * @param args Target server.
+ *
+ * @returns Always returns NULL.
+ */
+static void *nanvix_rpc_dispatch(void *args)
+{
+	struct nanvix_rpc_server *server = args;
+	uint64_t request[NANVIX_RPC_BUFFER_LENGTH];
+	uint64_t response[NANVIX_RPC_BUFFER_LENGTH];
+
+	while (nanvix_rpc_read(server, request) == 0)
+	{
+		int ret;
+		int opcode;
+		int nwakeups;
+		uint64_t t0, t1;
+		message_header *header;
+
+		header = (message_header *) request;
+		opcode = header->opcode;
+
+		/* Unknown operation. */
+		if ((opcode >= NANVIX_RPC_OPCODES_MAX) || (server->handlers[opcode] == NULL))
+		{
+			uprintf("[nanvix][rpc] dropping request with opcode %d", opcode);
+			continue;
+		}
+
+		nanvix_rpc_lock(server);
+
+			/* Shut down while waiting for handlers. */
+			if (nanvix_rpc_stopped(server))
+			{
+				nanvix_rpc_unlock(server);
+				break;
+			}
+
+			uassert(kernel_clock(&t0) == 0);
+
+			umemcpy(response, request, server->size);
+			ret = server->handlers[opcode](server, request, response);
+
+			/* Send response. */
+			if (ret == NANVIX_RPC_REPLY)
+			{
+				((message_header *) response)->tag = header->tag;
+				uassert(
+					nanvix_rpc_reply(
+						server,
+						header->source,
+						header->mailbox_port,
+						response
+					) == 0
+				);
+			}
+
+			uassert(kernel_clock(&t1) == 0);
+			nanvix_rpc_account(server, opcode, t1 - t0);
+
+			/* Shut down. */
+			nwakeups = (ret == NANVIX_RPC_SHUTDOWN) ? nanvix_rpc_stop(server) : 0;
+
+		nanvix_rpc_unlock(server);
+
+		nanvix_rpc_wakeup(server, nwakeups);
+	}
+
+	return (NULL);
+}
+
+/*============================================================================*
+ * nanvix_rpc_loop()                                                          *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_loop() function dispatches requests of the RPC server
+ * pointed to by @p server, until some handler asks for a shutdown.
+ * Requests are dispatched by the calling thread and by @p nthreads - 1
+ * additional threads. Unless the server has the NANVIX_RPC_CONCURRENT
+ * flag, handlers run one at a time and extra threads only overlap
+ * mailbox transfers. On shutdown, threads that are blocked in the
+ * input mailbox are woken up, and requests that are still pending are
+ * left unanswered.
+ */
+int nanvix_rpc_loop(struct nanvix_rpc_server *server, int nthreads)
+{
+	kthread_t tids[NANVIX_RPC_THREADS_MAX];
+
+	/* Invalid server. */
+	if (server == NULL)
+		return (-EINVAL);
+
+	/* Invalid number of threads. */
+	if ((nthreads < 1) || (nthreads > NANVIX_RPC_THREADS_MAX))
+		return (-EINVAL);
+
+	server->nthreads = nthreads;
+
+	for (int i = 1; i < nthreads; i++)
+		uassert(kthread_create(&tids[i], nanvix_rpc_dispatch, server) == 0);
+
+	nanvix_rpc_dispatch(server);
+
+	for (int i = 1; i < nthreads; i++)
+		uassert(kthread_join(tids[i], NULL) == 0);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rpc_send()                                                          *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_send() function tags the request pointed to by @p
+ * msg and sends it through @p outbox. The response is collected later
+ * with nanvix_rpc_recv(), so that several requests may be outstanding
+ * at once.
+ */
+int nanvix_rpc_send(int outbox, void *msg, size_t size)
+{
+	int ret;
+	int tag;
+
+	/* Invalid message. */
+	if ((msg == NULL) || (size < sizeof(message_header)))
+		return (-EINVAL);
+
+	if ((tag = nanvix_inbox_tag()) < 0)
+		return (tag);
+
+	((message_header *) msg)->tag = tag;
+
+	if ((ret = kmailbox_write(outbox, msg, size)) != (ssize_t) size)
+	{
+		nanvix_inbox_untag(tag);
+		return ((ret < 0) ? ret : -EIO);
+	}
+
+	return (tag);
+}
+
+/*============================================================================*
+ * nanvix_rpc_recv()                                                          *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_recv() function waits for the response of the
+ * request tagged with @p tag, and then releases the tag. Responses to
+ * other requests are left for their own callers.
+ */
+int nanvix_rpc_recv(int tag, void *msg, size_t size)
+{
+	ssize_t ret;
+
+	/* Invalid message. */
+	if ((msg == NULL) || (size < sizeof(message_header)))
+		return (-EINVAL);
+
+	ret = nanvix_inbox_read(tag, msg, size);
+
+	nanvix_inbox_untag(tag);
+
+	if (ret != (ssize_t) size)
+		return ((ret < 0) ? ret : -EIO);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rpc_call()                                                          *
+ *============================================================================*/
+
+/**
+ * The nanvix_rpc_call() function sends the request pointed to by @p
+ * msg through @p outbox, and waits for the matching response.
+ */
+int nanvix_rpc_call(int outbox, void *msg, size_t size)
+{
+	int tag;
+
+	if ((tag = nanvix_rpc_send(outbox, msg, size)) < 0)
+		return (tag);
+
+	return (nanvix_rpc_recv(tag, msg, size));
+}
@@ -35,12 +35,15 @@ extern int rmem_server(struct nanvix_semaphore *);
 /**
  * @brief Number of servers.
  */
-#define SPAWN_SERVERS_NUM 1
+#define SPAWN_SERVERS_NUM ((NAME_SERVERS_NUM > 1) ? 2 : 1)
 
 /**
  * @brief Table of servers.
  */
 const struct serverinfo spawn_servers[SPAWN_SERVERS_NUM] = {
+#if (NAME_SERVERS_NUM > 1)
+	{ .ring = SPAWN_RING_0, .main = name_server },
+#endif
 	{ .ring = SPAWN_RING_1, .main = rmem_server },
 };
 
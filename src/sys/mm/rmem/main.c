@@ -30,6 +30,7 @@
 #include <nanvix/servers/spawn.h>
 #include <nanvix/runtime/stdikc.h>
 #include <nanvix/runtime/runtime.h>
+#include <nanvix/runtime/rpc.h>
 #include <nanvix/runtime/utils.h>
 #include <nanvix/sys/thread.h>
 #include <nanvix/sys/mailbox.h>
@@ -78,12 +79,8 @@ static struct
 	unsigned nwrites;   /**< Number of writes.      */
 	uint64_t tstart;    /**< Start time.            */
 	uint64_t tshutdown; /**< Shutdown time.         */
-	uint64_t talloc;    /**< Allocation time.       */
-	uint64_t tfree;     /**< Free time.             */
-	uint64_t tread;     /**< Read time.             */
-	uint64_t twrite;    /**< Write time.            */
 	unsigned nblocks;   /**< Blocks allocated       */
-} stats = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+} stats = { 0, 0, 0, 0, 0, 0, 0 };
 
 /**
  * @brief Node number.
@@ -91,9 +88,9 @@ static struct
 static int nodenum;
 
 /**
- * @brief Input mailbox for small messages.
+ * @brief RPC server.
  */
-static int inbox;
+static struct nanvix_rpc_server rpc;
 
 /**
  * @brief Input portal for receiving data.
@@ -117,6 +114,15 @@ static struct
 	bitmap_t bitmap[RMEM_NUM_BLOCKS/BITMAP_WORD_LENGTH]; /**< Allocation Map */
 } rmem;
 
+#ifndef __RMEM_USES_MAILBOX
+
+/**
+ * @brief Staging buffer for runs that have holes.
+ */
+static char run_buffer[RMEM_RUN_MAX*RMEM_BLOCK_SIZE];
+
+#endif
+
 /**
  * @brief Map of blocks.
  */
@@ -159,6 +165,72 @@ static int rmem_server_get_id(void)
 	return (-1);
 }
 
+/*============================================================================*
+ * rmem_run_first_free()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Searches for a free run of blocks.
+ *
+ * @param nblocks Length of the run.
+ *
+ * @returns Upon successful completion, the number of the first block
+ * of a free run that is aligned to @p nblocks is returned. Upon
+ * failure, @p BITMAP_FULL is returned instead.
+ */
+static bitmap_t rmem_run_first_free(int nblocks)
+{
+	/* Single block. */
+	if (nblocks == 1)
+	{
+		return (bitmap_first_free(
+			rmem.bitmap,
+			(RMEM_NUM_BLOCKS/BITMAP_WORD_LENGTH)*sizeof(bitmap_t)
+		));
+	}
+
+	for (bitmap_t base = 0; (base + nblocks) <= RMEM_NUM_BLOCKS; base += nblocks)
+	{
+		int i;
+
+		/* Check if all blocks in this run are free. */
+		for (i = 0; i < nblocks; i++)
+		{
+			if (bitmap_check_bit(rmem.bitmap, base + i))
+				break;
+		}
+
+		/* Found. */
+		if (i == nblocks)
+			return (base);
+	}
+
+	return (BITMAP_FULL);
+}
+
+/*============================================================================*
+ * rmem_block_is_hole()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not a block of a run is a hole.
+ *
+ * @param _blknum Number of the target block.
+ * @param owner   Owner of the run.
+ *
+ * @returns One if the target block is not allocated to @p owner, and
+ * zero otherwise.
+ *
+ * @note Reads from holes yield zeros and writes to holes are dropped.
+ */
+static inline int rmem_block_is_hole(rpage_t _blknum, nanvix_pid_t owner)
+{
+	return (
+		!bitmap_check_bit(rmem.bitmap, _blknum) ||
+		(rmem.owners[_blknum] != owner)
+	);
+}
+
 /*============================================================================*
  * do_rmem_alloc()                                                            *
  *============================================================================*/
@@ -166,35 +238,45 @@ static int rmem_server_get_id(void)
 /**
  * @brief Handles remote memory allocation.
  *
- * @param owner Owner of the block.
+ * @param owner   Owner of the block.
+ * @param nblocks Number of blocks to allocate.
  *
- * @returns Upon successful completion, the number of the newly
- * allocated remote memory block is allocated. Upon failure, @p
- * RMEM_NULL is returned instead.
+ * @returns Upon successful completion, the number of the first block
+ * of the newly allocated run of remote memory blocks is returned. Upon
+ * failure, @p RMEM_NULL is returned instead.
  */
-static inline rpage_t do_rmem_alloc(nanvix_pid_t owner)
+static inline rpage_t do_rmem_alloc(nanvix_pid_t owner, int nblocks)
 {
 	bitmap_t bit;
 
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX))
+	{
+		uprintf("[nanvix][rmem] invalid run length");
+		return (RMEM_NULL);
+	}
+
 	/* Memory server is full. */
-	if (stats.nblocks == RMEM_NUM_BLOCKS)
+	if ((stats.nblocks + nblocks) > RMEM_NUM_BLOCKS)
 	{
 		uprintf("[nanvix][rmem] remote memory full");
 		return (RMEM_NULL);
 	}
 
-	/* Find a free block. */
-	uassert(
-		(bit = bitmap_first_free(
-			rmem.bitmap,
-			(RMEM_NUM_BLOCKS/BITMAP_WORD_LENGTH)*sizeof(bitmap_t)
-		)) != BITMAP_FULL
-	);
+	/* Find a free run. */
+	if ((bit = rmem_run_first_free(nblocks)) == BITMAP_FULL)
+	{
+		uprintf("[nanvix][rmem] remote memory too fragmented");
+		return (RMEM_NULL);
+	}
 
-	/* Allocate block. */
-	stats.nblocks++;
-	bitmap_set(rmem.bitmap, bit);
-	rmem.owners[bit] = owner;
+	/* Allocate blocks. */
+	for (int i = 0; i < nblocks; i++)
+	{
+		stats.nblocks++;
+		bitmap_set(rmem.bitmap, bit + i);
+		rmem.owners[bit + i] = owner;
+	}
 	rmem_debug("rmem_alloc() blknum=%d nblocks=%d/%d",
 		bit, stats.nblocks, RMEM_NUM_BLOCKS
 	);
@@ -271,12 +353,15 @@ static inline int do_rmem_free(rpage_t blknum, nanvix_pid_t owner)
 /**
  * @brief Handles a write request.
  *
- * @param remote Remote client.
- * @param blknum Number of the target block.
+ * @param remote      Remote client.
+ * @param blknum      Number of the first target block.
+ * @param nblocks     Number of blocks to write.
+ * @param remote_port Port number of the remote portal.
  */
-static inline int do_rmem_write(int remote, rpage_t blknum, int remote_port)
+static inline int do_rmem_write(int remote, rpage_t blknum, int nblocks, int remote_port)
 {
 	int ret = 0;
+	int nholes = 0;
 	rpage_t _blknum;
 
 	rmem_debug("write() nodenum=%d blknum=%x",
@@ -293,25 +378,83 @@ static inline int do_rmem_write(int remote, rpage_t blknum, int remote_port)
 		return (-EINVAL);
 	}
 
-	/*
-	 * Bad block number. Drop this read and return
-	 * an error. Note that we use the NULL block for this.
-	 */
-	if (!bitmap_check_bit(rmem.bitmap, _blknum))
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX) || ((_blknum + nblocks) > RMEM_NUM_BLOCKS))
 	{
-		uprintf("[nanvix][rmem] bad write block");
-		_blknum = 0;
-		ret = -EFAULT;
+		uprintf("[nanvix][rmem] invalid run length");
+		return (-EINVAL);
 	}
 
 	uassert(kportal_allow(inportal, remote, remote_port) == 0);
+
+	/* Single block. */
+	if (nblocks == 1)
+	{
+		/*
+		 * Bad block number. Drop this read and return
+		 * an error. Note that we use the NULL block for this.
+		 */
+		if (!bitmap_check_bit(rmem.bitmap, _blknum))
+		{
+			uprintf("[nanvix][rmem] bad write block");
+			_blknum = 0;
+			ret = -EFAULT;
+		}
+
+		uassert(
+			kportal_read(
+				inportal,
+				&rmem.blocks[_blknum*RMEM_BLOCK_SIZE],
+				RMEM_BLOCK_SIZE
+			) == RMEM_BLOCK_SIZE
+		);
+
+		return (ret);
+	}
+
+	for (int i = 0; i < nblocks; i++)
+		nholes += rmem_block_is_hole(_blknum + i, remote);
+
+	/* Bad run. */
+	if (nholes == nblocks)
+	{
+		uprintf("[nanvix][rmem] bad write run");
+		ret = -EFAULT;
+	}
+
+	/* Write the whole run in place. */
+	if (nholes == 0)
+	{
+		uassert(
+			kportal_read(
+				inportal,
+				&rmem.blocks[_blknum*RMEM_BLOCK_SIZE],
+				nblocks*RMEM_BLOCK_SIZE
+			) == nblocks*RMEM_BLOCK_SIZE
+		);
+
+		return (ret);
+	}
+
+	/* Stage the run and drop writes to holes. */
 	uassert(
 		kportal_read(
 			inportal,
-			&rmem.blocks[_blknum*RMEM_BLOCK_SIZE],
-			RMEM_BLOCK_SIZE
-		) == RMEM_BLOCK_SIZE
+			run_buffer,
+			nblocks*RMEM_BLOCK_SIZE
+		) == nblocks*RMEM_BLOCK_SIZE
 	);
+	for (int i = 0; i < nblocks; i++)
+	{
+		if (rmem_block_is_hole(_blknum + i, remote))
+			continue;
+
+		umemcpy(
+			&rmem.blocks[(_blknum + i)*RMEM_BLOCK_SIZE],
+			&run_buffer[i*RMEM_BLOCK_SIZE],
+			RMEM_BLOCK_SIZE
+		);
+	}
 
 	return (ret);
 }
@@ -374,23 +517,28 @@ static inline int do_rmem_write(rpage_t blknum, size_t offset, const char *paylo
 /**
  * @brief Handles a read request.
  *
- * @param remote Remote client.
- * @param blknum Number of the target block.
- * @param outbox Output mailbox to remote client.
+ * @param remote  Remote client.
+ * @param blknum  Number of the first target block.
+ * @param nblocks Number of blocks to read.
+ * @param outbox  Output mailbox to remote client.
+ * @param outport Port number of the remote portal.
+ * @param tag     Tag of the request.
  *
  * @returns Upon successful completion, zero is returned. Upon
  * failure, a negative error code is returned instead.
  */
-static inline int do_rmem_read(int remote, rpage_t blknum, int outbox, int outport)
+static inline int do_rmem_read(int remote, rpage_t blknum, int nblocks, int outbox, int outport, int tag)
 {
 	int ret = 0;
+	int nholes = 0;
 	int outportal;
 	rpage_t _blknum;
+	const char *data;
 	struct rmem_message msg;
 
 	/* Build operation header. */
-	msg.header.source = knode_get_num();
-	msg.header.opcode = RMEM_ACK;
+	message_header_build(&msg.header, RMEM_ACK);
+	msg.header.tag = tag;
 
 	rmem_debug("read() nodenum=%d blknum=%x",
 		remote,
@@ -406,15 +554,64 @@ static inline int do_rmem_read(int remote, rpage_t blknum, int outbox, int outpo
 		return (-EINVAL);
 	}
 
-	/*
-	 * Bad block number. Let us send a null block
-	 * and return an error instead.
-	 */
-	if (!bitmap_check_bit(rmem.bitmap, _blknum))
+	/* Invalid run length. */
+	if ((nblocks < 1) || (nblocks > RMEM_RUN_MAX) || ((_blknum + nblocks) > RMEM_NUM_BLOCKS))
 	{
-		uprintf("[nanvix][rmem] bad read block");
-		_blknum = 0;
-		ret = -EFAULT;
+		uprintf("[nanvix][rmem] invalid run length");
+		return (-EINVAL);
+	}
+
+	/* Single block. */
+	if (nblocks == 1)
+	{
+		/*
+		 * Bad block number. Let us send a null block
+		 * and return an error instead.
+		 */
+		if (!bitmap_check_bit(rmem.bitmap, _blknum))
+		{
+			uprintf("[nanvix][rmem] bad read block");
+			_blknum = 0;
+			ret = -EFAULT;
+		}
+
+		data = &rmem.blocks[_blknum*RMEM_BLOCK_SIZE];
+	}
+
+	/* Run of blocks. */
+	else
+	{
+		for (int i = 0; i < nblocks; i++)
+			nholes += rmem_block_is_hole(_blknum + i, remote);
+
+		/* Bad run. */
+		if (nholes == nblocks)
+		{
+			uprintf("[nanvix][rmem] bad read run");
+			ret = -EFAULT;
+		}
+
+		data = &rmem.blocks[_blknum*RMEM_BLOCK_SIZE];
+
+		/* Stage the run and fill holes with zeros. */
+		if (nholes > 0)
+		{
+			for (int i = 0; i < nblocks; i++)
+			{
+				if (rmem_block_is_hole(_blknum + i, remote))
+					umemset(&run_buffer[i*RMEM_BLOCK_SIZE], 0, RMEM_BLOCK_SIZE);
+				else
+				{
+					umemcpy(
+						&run_buffer[i*RMEM_BLOCK_SIZE],
+						&rmem.blocks[(_blknum + i)*RMEM_BLOCK_SIZE],
+						RMEM_BLOCK_SIZE
+					);
+				}
+			}
+
+			data = run_buffer;
+		}
 	}
 
 	uassert((outportal =
@@ -434,9 +631,9 @@ static inline int do_rmem_read(int remote, rpage_t blknum, int outbox, int outpo
 	uassert(
 		kportal_write(
 			outportal,
-			&rmem.blocks[_blknum*RMEM_BLOCK_SIZE],
-			RMEM_BLOCK_SIZE
-		) == RMEM_BLOCK_SIZE
+			data,
+			nblocks*RMEM_BLOCK_SIZE
+		) == nblocks*RMEM_BLOCK_SIZE
 	);
 	uassert(kportal_close(outportal) == 0);
 
@@ -451,19 +648,20 @@ static inline int do_rmem_read(int remote, rpage_t blknum, int outbox, int outpo
  * @param remote Remote client.
  * @param blknum Number of the target block.
  * @param outbox Output mailbox to remote client.
+ * @param tag    Tag of the request.
  *
  * @returns Upon successful completion, zero is returned. Upon
  * failure, a negative error code is returned instead.
  */
-static inline int do_rmem_read(rpage_t blknum, int outbox)
+static inline int do_rmem_read(rpage_t blknum, int outbox, int tag)
 {
 	int ret = 0;
 	rpage_t _blknum;
 	struct rmem_message msg;
 
 	/* Build operation header. */
-	msg.header.source = knode_get_num();
-	msg.header.opcode = RMEM_ACK;
+	message_header_build(&msg.header, RMEM_ACK);
+	msg.header.tag = tag;
 	msg.blknum = blknum;
 
 	rmem_debug("read() nodenum=%d blknum=%x",
@@ -514,6 +712,111 @@ static inline int do_rmem_read(rpage_t blknum, int outbox)
 
 #endif
 
+/*============================================================================*
+ * RPC Handlers                                                               *
+ *============================================================================*/
+
+/**
+ * @brief Handles a write request.
+ */
+static int rmem_rpc_write(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	struct rmem_message *msg = response;
+
+	((void) server);
+	((void) request);
+
+	stats.nwrites++;
+
+	#ifndef __RMEM_USES_MAILBOX
+	msg->errcode = do_rmem_write(msg->header.source, msg->blknum, msg->nblocks, msg->header.portal_port);
+	#else
+	msg->errcode = do_rmem_write(msg->blknum, msg->offset, msg->payload);
+
+	/*
+	 * Only the last chunk of a block is acknowledged. Chunks are
+	 * handled in order by a single dispatch thread, and all of them
+	 * fail alike, so its error code stands for the whole block.
+	 */
+	if ((msg->offset + RMEM_PAYLOAD_SIZE) < RMEM_BLOCK_SIZE)
+		return (NANVIX_RPC_NOREPLY);
+	#endif
+
+	return (NANVIX_RPC_REPLY);
+}
+
+/**
+ * @brief Handles a read request.
+ */
+static int rmem_rpc_read(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	int source;
+	struct rmem_message *msg = response;
+
+	((void) request);
+
+	stats.nreads++;
+
+	uassert((source = nanvix_rpc_channel(server, msg->header.source, msg->header.mailbox_port)) >= 0);
+
+	#ifndef __RMEM_USES_MAILBOX
+	msg->errcode = do_rmem_read(msg->header.source, msg->blknum, msg->nblocks, source, msg->header.portal_port, msg->header.tag);
+	#else
+	msg->errcode = do_rmem_read(msg->blknum, source, msg->header.tag);
+	#endif
+
+	return (NANVIX_RPC_REPLY);
+}
+
+/**
+ * @brief Handles an allocation request.
+ */
+static int rmem_rpc_alloc(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	struct rmem_message *msg = response;
+
+	((void) server);
+	((void) request);
+
+	stats.nallocs++;
+
+	msg->blknum = do_rmem_alloc(msg->header.source, msg->nblocks);
+	msg->errcode = (msg->blknum == RMEM_NULL) ? RMEM_NULL : msg->blknum;
+
+	return (NANVIX_RPC_REPLY);
+}
+
+/**
+ * @brief Handles a free request.
+ */
+static int rmem_rpc_free(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	struct rmem_message *msg = response;
+
+	((void) server);
+	((void) request);
+
+	stats.nfrees++;
+
+	msg->errcode = do_rmem_free(msg->blknum, msg->header.source);
+
+	return (NANVIX_RPC_REPLY);
+}
+
+/**
+ * @brief Handles a shutdown request.
+ */
+static int rmem_rpc_exit(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+	((void) request);
+	((void) response);
+
+	kclock(&stats.tshutdown);
+
+	return (NANVIX_RPC_SHUTDOWN);
+}
+
 /*============================================================================*
  * do_rmem_loop()                                                             *
  *============================================================================*/
@@ -526,100 +829,18 @@ static inline int do_rmem_read(rpage_t blknum, int outbox)
  */
 static int do_rmem_loop(void)
 {
-	int shutdown = 0;
-	uint64_t t0, t1;
+	int ret;
 
 	kclock(&stats.tstart);
 
-	while(!shutdown)
-	{
-		int source;
-		struct rmem_message msg;
+	uassert(nanvix_rpc_register(&rpc, RMEM_WRITE, rmem_rpc_write) == 0);
+	uassert(nanvix_rpc_register(&rpc, RMEM_READ, rmem_rpc_read) == 0);
+	uassert(nanvix_rpc_register(&rpc, RMEM_ALLOC, rmem_rpc_alloc) == 0);
+	uassert(nanvix_rpc_register(&rpc, RMEM_MEMFREE, rmem_rpc_free) == 0);
+	uassert(nanvix_rpc_register(&rpc, RMEM_EXIT, rmem_rpc_exit) == 0);
 
-		uassert(
-			kmailbox_read(
-				inbox,
-				&msg,
-				sizeof(struct rmem_message)
-			) == sizeof(struct rmem_message)
-		);
-
-		rmem_debug("rmem request source=%d port=%d opcode=%d",
-			msg.header.source,
-			msg.header.portal_port,
-			msg.header.opcode
-		);
-
-		/* handle write operation. */
-		switch (msg.header.opcode)
-		{
-			/* Write to RMEM. */
-			case RMEM_WRITE:
-				stats.nwrites++;
-				kclock(&t0);
-					#ifndef __RMEM_USES_MAILBOX
-					msg.errcode = do_rmem_write(msg.header.source, msg.blknum, msg.header.portal_port);
-					#else
-					msg.errcode = do_rmem_write(msg.blknum, msg.offset, msg.payload);
-					#endif
-					uassert((source = kmailbox_open(msg.header.source, msg.header.mailbox_port)) >= 0);
-					uassert(kmailbox_write(source, &msg, sizeof(struct rmem_message)) == sizeof(struct rmem_message));
-					uassert(kmailbox_close(source) == 0);
-				kclock(&t1);
-				stats.twrite += (t1 - t0);
-				break;
-
-			/* Read a page. */
-			case RMEM_READ:
-				stats.nreads++;
-				kclock(&t0);
-					uassert((source = kmailbox_open(msg.header.source, msg.header.mailbox_port)) >= 0);
-					#ifndef __RMEM_USES_MAILBOX
-					msg.errcode = do_rmem_read(msg.header.source, msg.blknum, source, msg.header.portal_port);
-					#else
-					msg.errcode = do_rmem_read(msg.blknum, source);
-					#endif
-					uassert(kmailbox_write(source, &msg, sizeof(struct rmem_message)) == sizeof(struct rmem_message));
-					uassert(kmailbox_close(source) == 0);
-				kclock(&t1);
-				stats.tread += (t1 - t0);
-				break;
-
-			/* Allocates a page. */
-			case RMEM_ALLOC:
-				stats.nallocs++;
-				kclock(&t0);
-					msg.blknum = do_rmem_alloc(msg.header.source);
-					msg.errcode = (msg.blknum == RMEM_NULL) ? RMEM_NULL : msg.blknum;
-					uassert((source = kmailbox_open(msg.header.source, msg.header.mailbox_port)) >= 0);
-					uassert(kmailbox_write(source, &msg, sizeof(struct rmem_message)) == sizeof(struct rmem_message));
-					uassert(kmailbox_close(source) == 0);
-				kclock(&t1);
-				stats.talloc += (t1 - t0);
-			    break;
-
-			/* Free frees a page. */
-			case RMEM_MEMFREE:
-				stats.nfrees++;
-				kclock(&t0);
-					msg.errcode = do_rmem_free(msg.blknum, msg.header.source);
-					uassert((source = kmailbox_open(msg.header.source, msg.header.mailbox_port)) >= 0);
-					uassert(kmailbox_write(source, &msg, sizeof(struct rmem_message)) == sizeof(struct rmem_message));
-					uassert(kmailbox_close(source) == 0);
-				kclock(&t1);
-				stats.tfree += (t1 - t0);
-			    break;
-
-			case RMEM_EXIT:
-				kclock(&stats.tshutdown);
-				shutdown = 1;
-				break;
-
-			/* Should not happen. */
-			default:
-				break;
-		}
-	}
+	if ((ret = nanvix_rpc_loop(&rpc, 1)) < 0)
+		return (ret);
 
 	/* Dump statistics. */
 	uprintf("[nanvix][rmem] nallocs=%d nfrees=%d nreads=%d nwrites=%d",
@@ -693,7 +914,15 @@ static int do_rmem_startup(struct nanvix_semaphore *lock)
 	nodenum = knode_get_num();
 
 	/* Assign input mailbox. */
-	inbox = stdinbox_get();
+	uassert(
+		nanvix_rpc_server_init(
+			&rpc,
+			stdinbox_get(),
+			stdinbox_get_port(),
+			sizeof(struct rmem_message),
+			0
+		) == 0
+	);
 
 	/* Assign input portal. */
 	inportal = stdinportal_get();
@@ -708,7 +937,7 @@ static int do_rmem_startup(struct nanvix_semaphore *lock)
 	/* Unblock spawner. */
 	uprintf("[nanvix][rmem] server alive");
 	uprintf("[nanvix][rmem] attached to node %d", knode_get_num());
-	uprintf("[nanvix][rmem] listening to mailbox %d", inbox);
+	uprintf("[nanvix][rmem] listening to mailbox %d", rpc.inbox);
 	uprintf("[nanvix][rmem] listening to portal %d", inportal);
 	uprintf("[nanvix][rmem] syncing in sync %d", stdsync_get());
 	uprintf("[nanvix][rmem] memory size %d KB", RMEM_SIZE/KB);
@@ -730,7 +959,7 @@ static int do_rmem_startup(struct nanvix_semaphore *lock)
  */
 static int do_rmem_shutdown(void)
 {
-	return (0);
+	return (nanvix_rpc_server_cleanup(&rpc));
 }
 
 /*============================================================================*
@@ -29,6 +29,7 @@
 #include <nanvix/servers/spawn.h>
 #include <nanvix/runtime/stdikc.h>
 #include <nanvix/runtime/runtime.h>
+#include <nanvix/runtime/rpc.h>
 #include <nanvix/sys/mailbox.h>
 #include <nanvix/sys/semaphore.h>
 #include <nanvix/limits.h>
@@ -51,18 +52,86 @@
 static int nr_registration = 0;
 
 /**
- * @brief Inbox.
+ * @brief RPC server.
  */
-static int inbox = -1;
+static struct nanvix_rpc_server rpc;
+
+/**
+ * @brief ID of this server.
+ */
+static int serverid = -1;
+
+/**
+ * @brief Maximum number of registered names.
+ */
+#define NAME_ENTRIES_MAX (4*NANVIX_PROC_MAX)
+
+/**
+ * @brief Number of buckets in the table of names (power of two).
+ */
+#define NAME_BUCKETS_NUM 128
+
+/**
+ * @brief Null entry.
+ */
+#define NAME_NULL (-1)
 
 /**
  * @brief Lookup table of process names.
+ *
+ * Entries are hashed by name, and are also chained by NoC node, so
+ * that all names of a node can be reached at once.
  */
 static struct {
-	int nodenum;                     /**< NoC node.                 */
-	char name[NANVIX_PROC_NAME_MAX]; /**< Process name.             */
-	uint64_t timestamp;              /**< Timestamp for heartbeats. */
-} procs[NANVIX_PROC_MAX];
+	int nodenum;                     /**< NoC node.                        */
+	char name[NANVIX_PROC_NAME_MAX]; /**< Process name.                    */
+	int next;                        /**< Next entry in the same bucket.   */
+	int node_next;                   /**< Next entry of the same NoC node. */
+} procs[NAME_ENTRIES_MAX];
+
+/**
+ * @brief Buckets of the table of names.
+ */
+static int buckets[NAME_BUCKETS_NUM];
+
+/**
+ * @brief NoC node index.
+ */
+static struct {
+	int entries;        /**< Names of the node.                        */
+	uint64_t timestamp; /**< Last heartbeat (zero if none was received). */
+} nodes[NANVIX_PROC_MAX];
+
+/**
+ * @brief Time of the last sweep for stale NoC nodes.
+ */
+static uint64_t last_sweep = 0;
+
+/**
+ * @brief List of free entries.
+ */
+static int free_entries = NAME_NULL;
+
+/**
+ * @brief Maximum number of pending waits.
+ */
+#define NAME_WAITERS_MAX (2*NANVIX_PROC_MAX)
+
+/**
+ * @brief Pending waits for names that are not linked yet.
+ */
+static struct {
+	int nodenum;                     /**< NoC node (-1 if free). */
+	int port;                        /**< Mailbox port.          */
+	uint8_t tag;                     /**< Request tag.           */
+	uint64_t timestamp;              /**< Time of the request.   */
+	char name[NANVIX_PROC_NAME_MAX]; /**< Awaited name.          */
+} waiters[NAME_WAITERS_MAX];
+
+/**
+ * @brief Number of pending waits.
+ */
+static int nwaiters = 0;
 
 /**
  * @brief Server stats.
@@ -72,7 +141,195 @@ static struct
 	int nlinks;         /**< Number of name link requests.   */
 	int nunlinks;       /**< Number of unlink name requests. */
 	int nlookups;       /**< Number of lookup requests.      */
-} stats = { 0, 0, 0};
+	int nevictions;     /**< Number of stale NoC nodes.      */
+} stats = { 0, 0, 0, 0 };
+
+/*===================================================================*
+ * Name Table                                                        *
+ *===================================================================*/
+
+/**
+ * @brief Gets the bucket of a name.
+ *
+ * @param name Target name.
+ *
+ * @returns The bucket of @p name.
+ */
+static int name_bucket(const char *name)
+{
+	/* Low bits are shared by names of the same server. */
+	return ((name_hash(name)/NAME_SERVERS_NUM) & (NAME_BUCKETS_NUM - 1));
+}
+
+/**
+ * @brief Searches for a name.
+ *
+ * @param name Target name.
+ *
+ * @returns If @p name is registered, the index of its entry is
+ * returned. Otherwise, NAME_NULL is returned instead.
+ */
+static int name_search(const char *name)
+{
+	for (int i = buckets[name_bucket(name)]; i != NAME_NULL; i = procs[i].next)
+	{
+		if (!ustrcmp(name, procs[i].name))
+			return (i);
+	}
+
+	return (NAME_NULL);
+}
+
+/**
+ * @brief Registers a name.
+ *
+ * @param nodenum NoC node.
+ * @param name    Target name.
+ *
+ * @returns Upon successful completion, the index of the new entry is
+ * returned. Upon failure, a negative error code is returned instead.
+ */
+static int name_insert(int nodenum, const char *name)
+{
+	int i;
+	int bucket;
+
+	/* No entry available. */
+	if ((i = free_entries) == NAME_NULL)
+		return (-EINVAL);
+
+	free_entries = procs[i].next;
+
+	bucket = name_bucket(name);
+	procs[i].nodenum = nodenum;
+	ustrcpy(procs[i].name, name);
+	procs[i].next = buckets[bucket];
+	buckets[bucket] = i;
+	procs[i].node_next = nodes[nodenum].entries;
+	nodes[nodenum].entries = i;
+
+	nr_registration++;
+
+	return (i);
+}
+
+/**
+ * @brief Unregisters a name.
+ *
+ * @param i Target entry.
+ */
+static void name_remove(int i)
+{
+	int *prev;
+
+	/* Unchain from bucket. */
+	for (prev = &buckets[name_bucket(procs[i].name)]; *prev != i; prev = &procs[*prev].next)
+		uassert(*prev != NAME_NULL);
+	*prev = procs[i].next;
+
+	/* Unchain from NoC node. */
+	for (prev = &nodes[procs[i].nodenum].entries; *prev != i; prev = &procs[*prev].node_next)
+		uassert(*prev != NAME_NULL);
+	*prev = procs[i].node_next;
+
+	ustrcpy(procs[i].name, "");
+	procs[i].nodenum = -1;
+	procs[i].node_next = NAME_NULL;
+	procs[i].next = free_entries;
+	free_entries = i;
+
+	nr_registration--;
+}
+
+/*===================================================================*
+ * Liveness                                                          *
+ *===================================================================*/
+
+/**
+ * @brief Gets the age of the names of a NoC node.
+ *
+ * @param nodenum Target NoC node.
+ *
+ * @returns The number of cycles since the last heartbeat of @p
+ * nodenum, or NAME_AGE_UNKNOWN if it never sent one.
+ */
+static uint64_t name_age(int nodenum)
+{
+	uint64_t now;
+
+	/* Not tracked. */
+	if (nodes[nodenum].timestamp == 0)
+		return (NAME_AGE_UNKNOWN);
+
+	uassert(kernel_clock(&now) == 0);
+
+	return (now - nodes[nodenum].timestamp);
+}
+
+/**
+ * @brief Records that a NoC node is alive.
+ *
+ * @param nodenum Target NoC node.
+ *
+ * @note Any request of a tracked node counts as a heartbeat.
+ */
+static void name_touch(int nodenum)
+{
+	/* Not tracked. */
+	if (!proc_is_valid(nodenum) || (nodes[nodenum].timestamp == 0))
+		return;
+
+	uassert(kernel_clock(&nodes[nodenum].timestamp) == 0);
+}
+
+/**
+ * @brief Unlinks names of NoC nodes that are no longer alive.
+ *
+ * Only nodes that have sent at least one heartbeat are tracked. To keep
+ * the cost of this off the request path, nodes are scanned at most once
+ * every quarter of NAME_ALIVE_TIMEOUT.
+ */
+static void name_sweep(void)
+{
+	uint64_t now;
+
+	/* Eviction disabled. */
+	if (NAME_ALIVE_TIMEOUT == 0)
+		return;
+
+	uassert(kernel_clock(&now) == 0);
+
+	/* Swept recently. */
+	if ((now - last_sweep) < (NAME_ALIVE_TIMEOUT/4))
+		return;
+
+	last_sweep = now;
+
+	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	{
+		/* Not tracked or alive. */
+		if ((nodes[i].timestamp == 0) || ((now - nodes[i].timestamp) <= NAME_ALIVE_TIMEOUT))
+			continue;
+
+		uprintf("[nanvix][name] node %d is not alive, unlinking its names", i);
+
+		while (nodes[i].entries != NAME_NULL)
+			name_remove(nodes[i].entries);
+
+		/* Nobody is left to get the replies. */
+		for (int j = 0; j < NAME_WAITERS_MAX; j++)
+		{
+			if (waiters[j].nodenum == i)
+			{
+				waiters[j].nodenum = -1;
+				nwaiters--;
+			}
+		}
+
+		nodes[i].timestamp = 0;
+		stats.nevictions++;
+	}
+}
 
 /*===================================================================*
  * do_name_init()                                                    *
@@ -84,26 +341,214 @@ static struct
 static void do_name_init(struct nanvix_semaphore *lock)
 {
 	/* Initialize lookup table. */
-	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	for (int i = 0; i < NAME_ENTRIES_MAX; i++)
 	{
 		procs[i].nodenum = -1;
-		procs[i].timestamp = 0;
+		procs[i].name[0] = '\0';
+		procs[i].node_next = NAME_NULL;
+		procs[i].next = (i + 1 < NAME_ENTRIES_MAX) ? (i + 1) : NAME_NULL;
 	}
+	free_entries = 0;
 
-	procs[0].nodenum = knode_get_num();
-	ustrcpy(procs[0].name, "/io0");
+	for (int i = 0; i < NAME_BUCKETS_NUM; i++)
+		buckets[i] = NAME_NULL;
 
-	uassert((inbox = stdinbox_get()) >= 0);
+	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	{
+		nodes[i].entries = NAME_NULL;
+		nodes[i].timestamp = 0;
+	}
+
+	for (int i = 0; i < NAME_WAITERS_MAX; i++)
+		waiters[i].nodenum = -1;
+
+	uassert(NAME_OPCODES_NUM <= NANVIX_RPC_OPCODES_MAX);
+	uassert(sizeof(struct name_message) <= NANVIX_MAILBOX_MESSAGE_SIZE);
+
+	/* Search for server. */
+	for (int i = 0; i < NAME_SERVERS_NUM; i++)
+	{
+		if (knode_get_num() == name_servers[i].nodenum)
+			serverid = i;
+	}
+	uassert(serverid >= 0);
+
+	/* Names are partitioned among servers. */
+	if (name_server_of("/io0") == serverid)
+		uassert(name_insert(NAME_SERVER_NODE, "/io0") >= 0);
+
+	uassert(
+		nanvix_rpc_server_init(
+			&rpc,
+			stdinbox_get(),
+			stdinbox_get_port(),
+			sizeof(struct name_message),
+			0
+		) == 0
+	);
 
 	/* Unblock spawner. */
 	uprintf("[nanvix][name] server alive");
-	uprintf("[nanvix][name] listening to mailbox %d", inbox);
+	uprintf("[nanvix][name] listening to mailbox %d", rpc.inbox);
 	uprintf("[nanvix][name] syncing in sync %d", stdsync_get());
 	uprintf("[nanvix][name] attached to node %d", knode_get_num());
+	uprintf("[nanvix][name] serving shard %d of %d", serverid, NAME_SERVERS_NUM);
 
 	nanvix_semaphore_up(lock);
 }
 
+/*=======================================================================*
+ * do_name_reply()                                                       *
+ *=======================================================================*/
+
+/**
+ * @brief Builds a reply to a client.
+ *
+ * @param response Response.
+ * @param ret      Return value of the request.
+ *
+ * @returns Always returns NANVIX_RPC_REPLY.
+ */
+static int do_name_reply(struct name_message *response, int ret)
+{
+	response->op.ret.errcode = ret;
+	message_header_build(
+		&response->header,
+		(ret <= 0) ? NAME_FAIL : NAME_SUCCESS
+	);
+
+	return (NANVIX_RPC_REPLY);
+}
+
+/*=======================================================================*
+ * do_name_wait()                                                        *
+ *=======================================================================*/
+
+/**
+ * @brief Defers the reply to a client until a name is linked.
+ *
+ * @param request Request.
+ *
+ * @returns Upon successful completion zero is returned. Upon failure, a
+ * negative error code is returned instead.
+ */
+static int do_name_wait(const struct name_message *request)
+{
+	int slot = -1;
+
+	name_debug("wait name=%s", request->op.lookup.name);
+
+	for (int i = 0; i < NAME_WAITERS_MAX; i++)
+	{
+		/* Free slot. */
+		if (waiters[i].nodenum == -1)
+		{
+			if (slot < 0)
+				slot = i;
+			continue;
+		}
+
+		/*
+		 * A client blocks on a single wait, so a new one from the
+		 * same mailbox means that the old one was abandoned.
+		 */
+		if ((waiters[i].nodenum == request->header.source) && (waiters[i].port == request->header.mailbox_port))
+		{
+			waiters[i].nodenum = -1;
+			nwaiters--;
+			slot = i;
+			break;
+		}
+	}
+
+	/* Too many waits. */
+	if (slot < 0)
+		return (-EAGAIN);
+
+	waiters[slot].nodenum = request->header.source;
+	waiters[slot].port = request->header.mailbox_port;
+	waiters[slot].tag = request->header.tag;
+	uassert(kernel_clock(&waiters[slot].timestamp) == 0);
+	ustrcpy(waiters[slot].name, request->op.lookup.name);
+	nwaiters++;
+
+	return (0);
+}
+
+/**
+ * @brief Replies to a pending wait.
+ *
+ * @param j        Target waiter.
+ * @param response Response.
+ */
+static void do_name_wakeup(int j, struct name_message *response)
+{
+	response->header.tag = waiters[j].tag;
+	uassert(nanvix_rpc_reply(&rpc, waiters[j].nodenum, waiters[j].port, response) == 0);
+	waiters[j].nodenum = -1;
+	nwaiters--;
+}
+
+/**
+ * @brief Wakes up clients waiting for a name.
+ *
+ * @param i Entry of the newly linked name.
+ */
+static void do_name_notify(int i)
+{
+	struct name_message response;
+
+	for (int j = 0; j < NAME_WAITERS_MAX; j++)
+	{
+		if (waiters[j].nodenum == -1)
+			continue;
+
+		if (ustrcmp(waiters[j].name, procs[i].name))
+			continue;
+
+		response.op.ret.nodenum = procs[i].nodenum;
+		response.op.ret.age = name_age(procs[i].nodenum);
+		do_name_reply(&response, 0);
+		do_name_wakeup(j, &response);
+	}
+}
+
+/**
+ * @brief Fails waits that have been pending for too long.
+ *
+ * Otherwise, a client that waits for a name that is never linked would
+ * block forever. Waits are checked on incoming requests, so they may
+ * outlive NAME_WAIT_TIMEOUT if the server is idle.
+ */
+static void do_name_expire(void)
+{
+	uint64_t now;
+	struct name_message response;
+
+	/* Expiration disabled or nothing to do. */
+	if ((NAME_WAIT_TIMEOUT == 0) || (nwaiters == 0))
+		return;
+
+	uassert(kernel_clock(&now) == 0);
+
+	for (int j = 0; j < NAME_WAITERS_MAX; j++)
+	{
+		if (waiters[j].nodenum == -1)
+			continue;
+
+		/* Not expired. */
+		if ((now - waiters[j].timestamp) <= NAME_WAIT_TIMEOUT)
+			continue;
+
+		name_debug("expire name=%s", waiters[j].name);
+
+		response.op.ret.nodenum = -1;
+		response.op.ret.age = NAME_AGE_UNKNOWN;
+		do_name_reply(&response, -ETIMEDOUT);
+		do_name_wakeup(j, &response);
+	}
+}
+
 /*=======================================================================*
  * do_name_lookup()                                                      *
  *=======================================================================*/
@@ -122,6 +567,7 @@ static int do_name_lookup(
 	struct name_message *response
 )
 {
+	int i;
 	int ret;
 	const char *name;
 
@@ -136,17 +582,13 @@ static int do_name_lookup(
 		return (ret);
 
 	/* Search for portal name. */
-	for (int i = 0; i < NANVIX_PROC_MAX; i++)
-	{
-		/* Found. */
-		if (!ustrcmp(name, procs[i].name))
-		{
-			response->op.ret.nodenum = procs[i].nodenum;
-			return (0);
-		}
-	}
+	if ((i = name_search(name)) == NAME_NULL)
+		return (-ENOENT);
 
-	return (-ENOENT);
+	response->op.ret.nodenum = procs[i].nodenum;
+	response->op.ret.age = name_age(procs[i].nodenum);
+
+	return (0);
 }
 
 /*=======================================================================*
@@ -164,7 +606,6 @@ static int do_name_lookup(
 static int do_name_link(const struct name_message *request)
 {
 	int ret;
-	int index;
 	int nodenum;
 	const char *name;
 
@@ -182,35 +623,14 @@ static int do_name_link(const struct name_message *request)
 	if ((ret = name_is_valid(name)) < 0)
 		return (ret);
 
-	/* No entry available. */
-	if (nr_registration >= NANVIX_PROC_MAX)
-		return (-EINVAL);
-
 	/* Check that the name is not already used */
-	for (int i = 0; i < NANVIX_PROC_MAX; i++)
-	{
-		if (ustrcmp(procs[i].name, name) == 0)
-			return (-EINVAL);
-	}
-
-	/* Find index. */
-	for (int i = 0; i < NANVIX_PROC_MAX; i++)
-	{
-		/* Found. */
-		if (procs[i].nodenum == -1)
-		{
-			index = i;
-			goto found;
-		}
-	}
-
-	return (-EINVAL);
+	if (name_search(name) != NAME_NULL)
+		return (-EINVAL);
 
-found:
+	if ((ret = name_insert(nodenum, name)) < 0)
+		return (ret);
 
-	nr_registration++;
-	procs[index].nodenum = nodenum;
-	ustrcpy(procs[index].name, name);
+	do_name_notify(ret);
 
 	return (0);
 }
@@ -229,12 +649,13 @@ found:
  */
 static int do_name_unlink(const struct name_message *request)
 {
+	int i;
 	int ret;
 	const char *name;
 
 	name = request->op.unlink.name;
 
-	stats.nlinks++;
+	stats.nunlinks++;
 	name_debug("unlink name=%s", name);
 
 	/* Invalid name. */
@@ -242,23 +663,12 @@ static int do_name_unlink(const struct name_message *request)
 		return (ret);
 
 	/* Search for name */
-	for (int i = 0; i < NANVIX_PROC_MAX; i++)
-	{
-		/* Skip invalid entries. */
-		if (procs[i].nodenum == -1)
-			continue;
+	if ((i = name_search(name)) == NAME_NULL)
+		return (-ENOENT);
 
-		/* Found*/
-		if (ustrcmp(procs[i].name, name) == 0)
-		{
-			nr_registration--;
-			ustrcpy(procs[i].name, "");
-			procs[i].nodenum = -1;
-			return (0);
-		}
-	}
+	name_remove(i);
 
-	return (-ENOENT);
+	return (0);
 }
 
 /*=======================================================================*
@@ -276,28 +686,336 @@ static int do_name_unlink(const struct name_message *request)
 static int do_name_heartbeat(const struct name_message *request)
 {
 	int nodenum;
-	uint64_t timestamp;
 
-	timestamp = request->op.heartbeat.timestamp;
 	nodenum = request->header.source;
 
-	name_debug("heartbeat nodenum=%d name=%l", nodenum, timestamp);
+	name_debug("heartbeat nodenum=%d name=%l", nodenum, request->op.heartbeat.timestamp);
 
 	/* Invalid node number. */
 	if (!proc_is_valid(nodenum))
 		return (-EINVAL);
 
-	/* Record timestamp. */
-	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	/* Opt out. */
+	if (!request->op.heartbeat.track)
+	{
+		nodes[nodenum].timestamp = 0;
+		return (0);
+	}
+
+	/*
+	 * Record timestamp. Clocks of different clusters are
+	 * not in sync, so the local one is used instead.
+	 */
+	uassert(kernel_clock(&nodes[nodenum].timestamp) == 0);
+
+	return (0);
+}
+
+/*=======================================================================*
+ * do_name_stats()                                                       *
+ *=======================================================================*/
+
+/**
+ * @brief Narrows a service time to 32 bits.
+ *
+ * @param cycles Service time.
+ *
+ * @returns @p cycles, saturated to UINT32_MAX.
+ */
+static inline uint32_t name_narrow(uint64_t cycles)
+{
+	return ((cycles > UINT32_MAX) ? UINT32_MAX : (uint32_t) cycles);
+}
+
+/**
+ * @brief Gets statistics of the server.
+ *
+ * @param request  Request.
+ * @param response Response.
+ *
+ * @returns Upon successful completion zero is returned. Upon failure, a
+ * negative error code is returned instead.
+ */
+static int do_name_stats(
+	const struct name_message *request,
+	struct name_message *response
+)
+{
+	((void) request);
+
+	response->op.ret_stats.nnames = nr_registration;
+	response->op.ret_stats.nlinks = stats.nlinks;
+	response->op.ret_stats.nunlinks = stats.nunlinks;
+	response->op.ret_stats.nlookups = stats.nlookups;
+	response->op.ret_stats.nevictions = stats.nevictions;
+
+	for (int opcode = 0, i = 0; opcode < NAME_OPCODES_NUM; opcode++)
+	{
+		uint64_t mean;
+
+		if (!name_opcode_is_timed(opcode))
+			continue;
+
+		mean = (rpc.stats[opcode].count > 0) ?
+			(rpc.stats[opcode].cycles/rpc.stats[opcode].count) : 0;
+
+		response->op.ret_stats.latency[i].count = rpc.stats[opcode].count;
+		response->op.ret_stats.latency[i].mean = name_narrow(mean);
+		response->op.ret_stats.latency[i].max = name_narrow(rpc.stats[opcode].max);
+		i++;
+	}
+
+	return (0);
+}
+
+/*=======================================================================*
+ * do_name_list()                                                        *
+ *=======================================================================*/
+
+/**
+ * @brief Gets the next registered name.
+ *
+ * @param request  Request.
+ * @param response Response.
+ *
+ * @returns Upon successful completion zero is returned. Upon failure, a
+ * negative error code is returned instead.
+ */
+static int do_name_list(
+	const struct name_message *request,
+	struct name_message *response
+)
+{
+	int cursor;
+
+	cursor = request->op.list.cursor;
+	response->op.ret_list.nodenum = -1;
+	response->op.ret_list.next = -1;
+
+	/* Invalid cursor. */
+	if (cursor < 0)
+		return (-EINVAL);
+
+	for (int i = cursor; i < NAME_ENTRIES_MAX; i++)
+	{
+		/* Free entry. */
+		if (procs[i].nodenum == -1)
+			continue;
+
+		response->op.ret_list.nodenum = procs[i].nodenum;
+		response->op.ret_list.next = i + 1;
+		response->op.ret_list.age = name_age(procs[i].nodenum);
+		ustrcpy(response->op.ret_list.name, procs[i].name);
+
+		return (0);
+	}
+
+	return (-ENOENT);
+}
+
+/*=======================================================================*
+ * do_name_many()                                                        *
+ *=======================================================================*/
+
+/**
+ * @brief Handles a batched name request.
+ *
+ * @param request  Request.
+ * @param response Response.
+ *
+ * @returns Upon successful completion zero is returned. Upon failure, a
+ * negative error code is returned instead. Per-name results are placed
+ * in @p response.
+ */
+static int do_name_many(
+	const struct name_message *request,
+	struct name_message *response
+)
+{
+	int count;
+	size_t off;
+	size_t len;
+	struct name_message req;
+
+	count = request->op.many.count;
+	response->op.ret_many.count = 0;
+
+	/* Invalid batch. */
+	if ((count < 0) || (count > NAME_BATCH_MAX))
+		return (-EINVAL);
+
+	req.header = request->header;
+
+	for (off = 0; response->op.ret_many.count < count; off += len + 1)
 	{
-		if (procs[i].nodenum == nodenum)
+		/* Name crosses the end of the batch. */
+		for (len = 0; ((off + len) < NAME_BATCH_SIZE) && (request->op.many.names[off + len] != '\0'); len++)
+			/* noop */;
+		if ((off + len) >= NAME_BATCH_SIZE)
+			return (-EINVAL);
+
+		ustrcpy(req.op.lookup.name, &request->op.many.names[off]);
+
+		/* Lookup and link requests share the same layout. */
+		if (request->header.opcode == NAME_LOOKUP_MANY)
+		{
+			int ret;
+			struct name_message resp;
+
+			ret = do_name_lookup(&req, &resp);
+			response->op.ret_many.values[response->op.ret_many.count++] =
+				(ret < 0) ? ret : resp.op.ret.nodenum;
+		}
+		else
 		{
-			procs[i].timestamp = timestamp;
-			return (0);
+			response->op.ret_many.values[response->op.ret_many.count++] =
+				do_name_link(&req);
 		}
 	}
 
-	return (-EINVAL);
+	return (0);
+}
+
+/*===================================================================*
+ * RPC Handlers                                                      *
+ *===================================================================*/
+
+/**
+ * @brief Does bookkeeping that is common to all requests.
+ *
+ * @param request Request.
+ */
+static void name_prologue(const struct name_message *request)
+{
+	#if (__DEBUG_NAME)
+	message_header_sprint(debug_str, (message_header *) &request->header);
+	uprintf("name request %s", debug_str);
+	#endif
+
+	/* Sweep first, so that nodes that were silent for too long are not revived. */
+	name_sweep();
+	name_touch(request->header.source);
+	do_name_expire();
+}
+
+/**
+ * @brief Handles a lookup request.
+ */
+static int name_rpc_lookup(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+
+	name_prologue(request);
+
+	return (do_name_reply(response, do_name_lookup(request, response)));
+}
+
+/**
+ * @brief Handles a link request.
+ */
+static int name_rpc_link(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+
+	name_prologue(request);
+
+	return (do_name_reply(response, do_name_link(request)));
+}
+
+/**
+ * @brief Handles a wait request.
+ */
+static int name_rpc_wait(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	int ret;
+
+	((void) server);
+
+	name_prologue(request);
+
+	/* Not linked yet: reply later. */
+	if ((ret = do_name_lookup(request, response)) == -ENOENT)
+	{
+		if ((ret = do_name_wait(request)) == 0)
+			return (NANVIX_RPC_NOREPLY);
+	}
+
+	return (do_name_reply(response, ret));
+}
+
+/**
+ * @brief Handles a batched request.
+ */
+static int name_rpc_many(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+
+	name_prologue(request);
+
+	return (do_name_reply(response, do_name_many(request, response)));
+}
+
+/**
+ * @brief Handles an unlink request.
+ */
+static int name_rpc_unlink(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+
+	name_prologue(request);
+
+	return (do_name_reply(response, do_name_unlink(request)));
+}
+
+/**
+ * @brief Handles a statistics request.
+ */
+static int name_rpc_stats(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+
+	name_prologue(request);
+
+	return (do_name_reply(response, do_name_stats(request, response)));
+}
+
+/**
+ * @brief Handles a listing request.
+ */
+static int name_rpc_list(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+
+	name_prologue(request);
+
+	return (do_name_reply(response, do_name_list(request, response)));
+}
+
+/**
+ * @brief Handles a heartbeat.
+ */
+static int name_rpc_alive(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+	((void) response);
+
+	name_prologue(request);
+
+	uassert(do_name_heartbeat(request) == 0);
+
+	return (NANVIX_RPC_NOREPLY);
+}
+
+/**
+ * @brief Handles a shutdown request.
+ */
+static int name_rpc_exit(struct nanvix_rpc_server *server, const void *request, void *response)
+{
+	((void) server);
+	((void) request);
+	((void) response);
+
+	return (NANVIX_RPC_SHUTDOWN);
 }
 
 /*===================================================================*
@@ -311,96 +1029,26 @@ static int do_name_heartbeat(const struct name_message *request)
  */
 int do_name_server(struct nanvix_semaphore *lock)
 {
-	int shutdown = 0;
-
 	uprintf("[nanvix][name] booting up server");
 	do_name_init(lock);
 
-	while (!shutdown)
-	{
-		int outbox;
-		int reply = 0;
-		int ret = -ENOSYS;
-		struct name_message request;
-		struct name_message response;
-
-		uassert(
-			kmailbox_read(
-				inbox,
-				&request,
-				sizeof(struct name_message)
-			) == sizeof(struct name_message)
-		);
-
-		#if (__DEBUG_NAME)
-		message_header_sprint(debug_str, &request.header);
-		uprintf("name request %s", debug_str);
-		#endif
-
-		/* Handle name requests. */
-		switch (request.header.opcode)
-		{
-			/* Lookup. */
-			case NAME_LOOKUP:
-				ret = do_name_lookup(&request, &response);
-				reply = 1;
-				break;
-
-			/* Add name. */
-			case NAME_LINK:
-				ret =  do_name_link(&request);
-				reply = 1;
-				break;
-
-			/* Remove name. */
-			case NAME_UNLINK:
-				stats.nunlinks++;
-				ret = do_name_unlink(&request);
-				reply = 1;
-				break;
-
-			case NAME_ALIVE:
-				uassert((ret = do_name_heartbeat(&request)) == 0);
-				break;
-
-			case NAME_EXIT:
-				shutdown = 1;
-				break;
-
-			/* Should not happen. */
-			default:
-				break;
-		}
+	uassert(nanvix_rpc_register(&rpc, NAME_LOOKUP, name_rpc_lookup) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_LINK, name_rpc_link) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_WAIT, name_rpc_wait) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_LOOKUP_MANY, name_rpc_many) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_LINK_MANY, name_rpc_many) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_UNLINK, name_rpc_unlink) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_STATS, name_rpc_stats) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_LIST, name_rpc_list) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_ALIVE, name_rpc_alive) == 0);
+	uassert(nanvix_rpc_register(&rpc, NAME_EXIT, name_rpc_exit) == 0);
 
-		/* No reply? */
-		if (!reply)
-			continue;
-
-		response.op.ret.errcode = ret;
-		message_header_build(
-			&response.header,
-			(ret <= 0) ? NAME_FAIL : NAME_SUCCESS
-		);
-
-		uassert((
-			outbox = kmailbox_open(
-				request.header.source,
-				request.header.mailbox_port
-			)) >= 0
-		);
-		uassert(
-			kmailbox_write(
-				outbox,
-				&response,
-				sizeof(struct name_message
-			)) == sizeof(struct name_message)
-		);
-		uassert(kmailbox_close(outbox) == 0);
-	}
+	uassert(nanvix_rpc_loop(&rpc, 1) == 0);
+	uassert(nanvix_rpc_server_cleanup(&rpc) == 0);
 
 	/* Dump statistics. */
-	uprintf("[nanvix][name] links=%d lookups=%d unlinks=%d",
-			stats.nlinks, stats.nlookups, stats.nunlinks
+	uprintf("[nanvix][name] links=%d lookups=%d unlinks=%d evictions=%d",
+			stats.nlinks, stats.nlookups, stats.nunlinks, stats.nevictions
 	);
 
 	return (0);
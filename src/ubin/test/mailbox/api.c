@@ -0,0 +1,208 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2011-2018 Pedro Henrique Penna <pedrohenriquepenna@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.  THE SOFTWARE IS PROVIDED
+ * "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <nanvix/runtime/mailbox.h>
+#include <nanvix/runtime/stdikc.h>
+#include <nanvix/sys/thread.h>
+#include <nanvix/ulib.h>
+#include <posix/errno.h>
+#include "../test.h"
+
+/**
+ * @brief Name of the test mailbox.
+ */
+#define MAILBOX_NAME "cool-mailbox"
+
+/**
+ * @brief Messages in flight.
+ */
+static struct
+{
+	int outbox;                              /**< Output mailbox.           */
+	const struct nanvix_mailbox_iovec *iov;  /**< Messages.                 */
+	int iovcnt;                              /**< Number of messages.       */
+	int ret;                                 /**< Result of writev().       */
+} sender;
+
+/**
+ * @brief Writes messages to the test mailbox.
+ *
+ * Mailboxes may buffer a single frame, so messages are written by
+ * another thread while the main one reads them.
+ */
+static void *test_mailbox_sender(void *args)
+{
+	((void) args);
+
+	sender.ret = nanvix_mailbox_writev(sender.outbox, sender.iov, sender.iovcnt);
+
+	return (NULL);
+}
+
+/*============================================================================*
+ * API Test: Writev Unpack                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Writev Unpack
+ */
+static void test_mailbox_writev_unpack(void)
+{
+	int inbox;
+	size_t end;
+	kthread_t tid;
+	char msg2[32];
+	char frame[NANVIX_MAILBOX_MESSAGE_SIZE];
+	struct nanvix_mailbox_iovec iov[3];
+	struct nanvix_mailbox_iovec iov2[3];
+
+	TEST_ASSERT((inbox = nanvix_mailbox_create(MAILBOX_NAME)) >= 0);
+	TEST_ASSERT((sender.outbox = nanvix_mailbox_open(MAILBOX_NAME, stdinbox_get_port())) >= 0);
+
+	umemset(msg2, 'x', sizeof(msg2));
+	iov[0].iov_base = "hello";
+	iov[0].iov_len = sizeof("hello");
+	iov[1].iov_base = msg2;
+	iov[1].iov_len = sizeof(msg2);
+	iov[2].iov_base = "world";
+	iov[2].iov_len = sizeof("world");
+	sender.iov = iov;
+	sender.iovcnt = 3;
+
+	/* Small messages share a frame. */
+	TEST_ASSERT(kthread_create(&tid, test_mailbox_sender, NULL) == 0);
+	TEST_ASSERT(nanvix_mailbox_read(inbox, frame, NANVIX_MAILBOX_MESSAGE_SIZE) == 0);
+	TEST_ASSERT(kthread_join(tid, NULL) == 0);
+	TEST_ASSERT(sender.ret == 1);
+
+	TEST_ASSERT(nanvix_mailbox_unpack(frame, NANVIX_MAILBOX_MESSAGE_SIZE, iov2, 3) == 3);
+	for (int i = 0; i < 3; i++)
+	{
+		TEST_ASSERT(iov2[i].iov_len == iov[i].iov_len);
+		TEST_ASSERT(umemcmp(iov2[i].iov_base, iov[i].iov_base, iov[i].iov_len) == 0);
+	}
+
+	/* Padding is zeroed. */
+	end = (const char *) iov2[2].iov_base - frame + iov2[2].iov_len;
+	for (size_t i = end; i < NANVIX_MAILBOX_MESSAGE_SIZE; i++)
+		TEST_ASSERT(frame[i] == 0);
+
+	/* Truncated frame. */
+	TEST_ASSERT(nanvix_mailbox_unpack(frame, end - 1, iov2, 3) == -EINVAL);
+	TEST_ASSERT(nanvix_mailbox_unpack(frame, sizeof(uint16_t), iov2, 3) == -EINVAL);
+
+	/* Not enough room. */
+	TEST_ASSERT(nanvix_mailbox_unpack(frame, NANVIX_MAILBOX_MESSAGE_SIZE, iov2, 2) == -ENOBUFS);
+
+	TEST_ASSERT(nanvix_mailbox_close(sender.outbox) == 0);
+	TEST_ASSERT(nanvix_mailbox_unlink(inbox) == 0);
+}
+
+/*============================================================================*
+ * API Test: Writev Frames                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Writev Frames
+ */
+static void test_mailbox_writev_frames(void)
+{
+	int inbox;
+	kthread_t tid;
+	char msg[NANVIX_MAILBOX_PACKED_MAX];
+	char frame[NANVIX_MAILBOX_MESSAGE_SIZE];
+	struct nanvix_mailbox_iovec iov[2];
+	struct nanvix_mailbox_iovec iov2[1];
+
+	TEST_ASSERT((inbox = nanvix_mailbox_create(MAILBOX_NAME)) >= 0);
+	TEST_ASSERT((sender.outbox = nanvix_mailbox_open(MAILBOX_NAME, stdinbox_get_port())) >= 0);
+
+	umemset(msg, 1, sizeof(msg));
+	iov[0].iov_base = msg;
+	iov[0].iov_len = sizeof(msg);
+	iov[1].iov_base = msg;
+	iov[1].iov_len = sizeof(msg);
+	sender.iov = iov;
+	sender.iovcnt = 2;
+
+	/* Large messages take a frame each. */
+	TEST_ASSERT(kthread_create(&tid, test_mailbox_sender, NULL) == 0);
+	for (int i = 0; i < 2; i++)
+	{
+		TEST_ASSERT(nanvix_mailbox_read(inbox, frame, NANVIX_MAILBOX_MESSAGE_SIZE) == 0);
+		TEST_ASSERT(nanvix_mailbox_unpack(frame, NANVIX_MAILBOX_MESSAGE_SIZE, iov2, 1) == 1);
+		TEST_ASSERT(iov2[0].iov_len == sizeof(msg));
+		TEST_ASSERT(umemcmp(iov2[0].iov_base, msg, sizeof(msg)) == 0);
+	}
+	TEST_ASSERT(kthread_join(tid, NULL) == 0);
+	TEST_ASSERT(sender.ret == 2);
+
+	TEST_ASSERT(nanvix_mailbox_close(sender.outbox) == 0);
+	TEST_ASSERT(nanvix_mailbox_unlink(inbox) == 0);
+}
+
+/*============================================================================*
+ * API Test: Writev Invalid                                                   *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Writev Invalid
+ */
+static void test_mailbox_writev_invalid(void)
+{
+	int inbox;
+	int outbox;
+	char msg[NANVIX_MAILBOX_PACKED_MAX + 1];
+	struct nanvix_mailbox_iovec iov[1];
+
+	TEST_ASSERT((inbox = nanvix_mailbox_create(MAILBOX_NAME)) >= 0);
+	TEST_ASSERT((outbox = nanvix_mailbox_open(MAILBOX_NAME, stdinbox_get_port())) >= 0);
+
+	/* Nothing is written if any message is bad. */
+	iov[0].iov_base = msg;
+	iov[0].iov_len = sizeof(msg);
+	TEST_ASSERT(nanvix_mailbox_writev(outbox, iov, 1) == -EINVAL);
+	iov[0].iov_base = NULL;
+	iov[0].iov_len = 1;
+	TEST_ASSERT(nanvix_mailbox_writev(outbox, iov, 1) == -EINVAL);
+	TEST_ASSERT(nanvix_mailbox_writev(outbox, NULL, 1) == -EINVAL);
+	TEST_ASSERT(nanvix_mailbox_writev(outbox, iov, 0) == -EINVAL);
+	TEST_ASSERT(nanvix_mailbox_unpack(NULL, NANVIX_MAILBOX_MESSAGE_SIZE, iov, 1) == -EINVAL);
+
+	TEST_ASSERT(nanvix_mailbox_close(outbox) == 0);
+	TEST_ASSERT(nanvix_mailbox_unlink(inbox) == 0);
+}
+
+/*============================================================================*
+ * API Test Driver Table                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Unit tests.
+ */
+struct test tests_mailbox_api[] = {
+	{ test_mailbox_writev_unpack,  "writev unpack"  },
+	{ test_mailbox_writev_frames,  "writev frames"  },
+	{ test_mailbox_writev_invalid, "writev invalid" },
+	{ NULL,                        NULL             }
+};
@@ -54,6 +54,8 @@ int __main2(int argc, const char *argv[])
 		test_name();
 
 		__runtime_setup(4);
+		test_mailbox();
+		test_rpc();
 		test_rmem_stub();
 		test_rmem_cache();
 		test_rmem_manager();
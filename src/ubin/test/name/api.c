@@ -23,9 +23,15 @@
 #define __NEED_NAME_CLIENT
 
 #include <nanvix/runtime/pm/name.h>
+#include <nanvix/runtime/inbox.h>
+#include <nanvix/runtime/stdikc.h>
+#include <nanvix/servers/message.h>
+#include <nanvix/sys/mailbox.h>
 #include <nanvix/sys/noc.h>
+#include <nanvix/sys/thread.h>
 #include <nanvix/limits.h>
 #include <nanvix/ulib.h>
+#include <posix/errno.h>
 #include "../test.h"
 
 /*============================================================================*
@@ -67,6 +73,133 @@ static void test_name_lookup(void)
 	TEST_ASSERT(name_unlink(pathname) == 0);
 }
 
+/*============================================================================*
+ * API Test: Lookup Cached                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Lookup Cached
+ */
+static void test_name_lookup_cached(void)
+{
+	int nodenum;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(name_lookup(pathname) == nodenum);
+	TEST_ASSERT(name_lookup(pathname) == nodenum);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+
+	/* Unlinked names are not served from the cache. */
+	TEST_ASSERT(name_lookup(pathname) < 0);
+}
+
+/*============================================================================*
+ * API Test: Lookup Many                                                      *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Lookup Many
+ */
+static void test_name_lookup_many(void)
+{
+	int nodenum;
+	int results[3];
+	const char *names[3] = { "cool-name0", "cool-name1", "cool-name2" };
+
+	nodenum = knode_get_num();
+
+	TEST_ASSERT(name_link_many(nodenum, names, results, 2) == 0);
+	TEST_ASSERT(results[0] == 0);
+	TEST_ASSERT(results[1] == 0);
+
+	TEST_ASSERT(name_lookup_many(names, results, 3) == 0);
+	TEST_ASSERT(results[0] == nodenum);
+	TEST_ASSERT(results[1] == nodenum);
+	TEST_ASSERT(results[2] < 0);
+
+	TEST_ASSERT(name_unlink(names[0]) == 0);
+	TEST_ASSERT(name_unlink(names[1]) == 0);
+}
+
+/*============================================================================*
+ * API Test: Wait                                                             *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Wait
+ */
+static void test_name_wait(void)
+{
+	int nodenum;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(name_wait(pathname) == nodenum);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+}
+
+/*============================================================================*
+ * API Test: Wait Deferred                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Result of a deferred wait.
+ */
+static int waited;
+
+/**
+ * @brief Waits for a name that is linked later on.
+ *
+ * The reply comes to the standard input mailbox of this thread, so it
+ * sets one up. The Name Service client is shared with the main thread.
+ */
+static void *test_name_waiter(void *args)
+{
+	uassert(__stdmailbox_setup() == 0);
+
+	waited = name_wait((const char *) args);
+
+	uassert(__stdmailbox_cleanup() == 0);
+
+	return (NULL);
+}
+
+/**
+ * @brief API Test: Wait Deferred
+ */
+static void test_name_wait_deferred(void)
+{
+	int nodenum;
+	kthread_t tid;
+	struct name_stats stats1, stats2;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_stats(&stats1) == 0);
+
+	waited = -1;
+	TEST_ASSERT(kthread_create(&tid, test_name_waiter, pathname) == 0);
+
+	/* Link only when the wait is pending in the server. */
+	do
+		TEST_ASSERT(name_stats(&stats2) == 0);
+	while (stats2.latency[NAME_WAIT].count == stats1.latency[NAME_WAIT].count);
+
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(kthread_join(tid, NULL) == 0);
+	TEST_ASSERT(waited == nodenum);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+}
+
 /*============================================================================*
  * API Test: Heartbeat                                                        *
  *============================================================================*/
@@ -84,9 +217,277 @@ static void test_name_heartbeat(void)
 	ustrcpy(pathname, "cool-name");
 	TEST_ASSERT(name_link(nodenum, pathname) == 0);
 	TEST_ASSERT(name_heartbeat() == 0);
+	TEST_ASSERT(name_heartbeat_stop() == 0);
 	TEST_ASSERT(name_unlink(pathname) == 0);
 }
 
+/*============================================================================*
+ * API Test: Lookup Age                                                       *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Lookup Age
+ */
+static void test_name_lookup_age(void)
+{
+	int nodenum;
+	uint64_t age;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(name_heartbeat() == 0);
+	TEST_ASSERT(name_lookup_age(pathname, &age) == nodenum);
+	TEST_ASSERT(age != NAME_AGE_UNKNOWN);
+	TEST_ASSERT(name_heartbeat_stop() == 0);
+	TEST_ASSERT(name_lookup_age(pathname, &age) == nodenum);
+	TEST_ASSERT(age == NAME_AGE_UNKNOWN);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+}
+
+/*============================================================================*
+ * API Test: Eviction                                                         *
+ *============================================================================*/
+
+#ifdef __NAME_ALIVE_TIMEOUT
+
+/**
+ * @brief API Test: Eviction
+ *
+ * Waits for longer than the liveness timeout, so it is only built when
+ * the timeout is lowered, e.g. with ADDONS=-D__NAME_ALIVE_TIMEOUT=1000.
+ */
+static void test_name_eviction(void)
+{
+	int nodenum;
+	uint64_t age;
+	uint64_t t0, t1;
+	struct name_stats stats1, stats2;
+	char pathname[NANVIX_PROC_NAME_MAX];
+	char pname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+	usprintf(pname, "cluster%d", nodenum);
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_stats(&stats1) == 0);
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(name_heartbeat() == 0);
+
+	/* Stay silent. */
+	TEST_ASSERT(kernel_clock(&t0) == 0);
+	do
+		TEST_ASSERT(kernel_clock(&t1) == 0);
+	while ((t1 - t0) <= (uint64_t) __NAME_ALIVE_TIMEOUT);
+
+	/* All names of this node were unlinked. */
+	TEST_ASSERT(name_lookup_age(pathname, &age) == -ENOENT);
+	TEST_ASSERT(name_lookup_age(pname, &age) == -ENOENT);
+	TEST_ASSERT(name_stats(&stats2) == 0);
+	TEST_ASSERT(stats2.nevictions > stats1.nevictions);
+	TEST_ASSERT(stats2.nnames == stats1.nnames - 1);
+
+	/* Restore the process name. */
+	TEST_ASSERT(name_link(nodenum, pname) == 0);
+}
+
+#endif
+
+/*============================================================================*
+ * API Test: Stats                                                            *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Stats
+ */
+static void test_name_stats(void)
+{
+	int nodenum;
+	struct name_stats stats1, stats2;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	TEST_ASSERT(name_stats(&stats1) == 0);
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(name_stats(&stats2) == 0);
+	TEST_ASSERT(stats2.nnames == stats1.nnames + 1);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+	TEST_ASSERT(name_stats(&stats2) == 0);
+
+	TEST_ASSERT(stats2.nnames == stats1.nnames);
+	TEST_ASSERT(stats2.nlinks == stats1.nlinks + 1);
+	TEST_ASSERT(stats2.nunlinks == stats1.nunlinks + 1);
+	TEST_ASSERT(stats2.latency[NAME_LINK].count == stats1.latency[NAME_LINK].count + 1);
+	TEST_ASSERT(stats2.latency[NAME_UNLINK].count == stats1.latency[NAME_UNLINK].count + 1);
+	TEST_ASSERT(stats2.latency[NAME_LINK].max > 0);
+	TEST_ASSERT(stats2.latency[NAME_LIST].count == 0);
+}
+
+/*============================================================================*
+ * API Test: List                                                             *
+ *============================================================================*/
+
+/**
+ * @brief API Test: List
+ */
+static void test_name_list(void)
+{
+	int found;
+	int cursor;
+	int nodenum;
+	int nodenum2;
+	uint64_t age;
+	char pathname[NANVIX_PROC_NAME_MAX];
+	char pathname2[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+
+	found = 0;
+	for (cursor = 0; (cursor = name_list(cursor, pathname2, &nodenum2, &age)) > 0; /* noop */)
+	{
+		if (!ustrcmp(pathname, pathname2))
+		{
+			TEST_ASSERT(nodenum2 == nodenum);
+			found++;
+		}
+	}
+
+	TEST_ASSERT(cursor == -ENOENT);
+	TEST_ASSERT(found == 1);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+}
+
+/*============================================================================*
+ * API Test: Inbox Tags                                                       *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Inbox Tags
+ */
+static void test_name_inbox_tags(void)
+{
+	int tag1;
+	int tag2;
+	int nodenum;
+	uint64_t age;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	/* Tags of outstanding requests are unique. */
+	TEST_ASSERT((tag1 = nanvix_inbox_tag()) > 0);
+	TEST_ASSERT((tag2 = nanvix_inbox_tag()) > 0);
+	TEST_ASSERT(tag1 != tag2);
+
+	/* Calls go through while other tags are outstanding. */
+	ustrcpy(pathname, "cool-name");
+	TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	TEST_ASSERT(name_lookup_age(pathname, &age) == nodenum);
+	TEST_ASSERT(name_unlink(pathname) == 0);
+
+	TEST_ASSERT(nanvix_inbox_untag(tag1) == 0);
+	TEST_ASSERT(nanvix_inbox_untag(tag2) == 0);
+	TEST_ASSERT(nanvix_inbox_untag(tag1) == -EINVAL);
+	TEST_ASSERT(nanvix_inbox_untag(NANVIX_INBOX_UNTAGGED) == -EINVAL);
+}
+
+/*============================================================================*
+ * API Test: Inbox Demux                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Messages sent to the standard input mailbox.
+ */
+static struct
+{
+	int outbox; /**< Output mailbox.     */
+	int n;      /**< Number of messages. */
+	char frames[NANVIX_INBOX_PARKED_MAX + 1][NANVIX_MAILBOX_MESSAGE_SIZE];
+} inbox_frames;
+
+/**
+ * @brief Sends messages to the standard input mailbox of the main thread.
+ *
+ * Mailboxes may buffer a single message, so these are sent by another
+ * thread while the main one reads them.
+ */
+static void *test_name_inbox_sender(void *args)
+{
+	((void) args);
+
+	for (int i = 0; i < inbox_frames.n; i++)
+	{
+		TEST_ASSERT(
+			kmailbox_write(
+				inbox_frames.outbox,
+				inbox_frames.frames[i],
+				NANVIX_MAILBOX_MESSAGE_SIZE
+			) == NANVIX_MAILBOX_MESSAGE_SIZE
+		);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief API Test: Inbox Demux
+ */
+static void test_name_inbox_demux(void)
+{
+	int tag;
+	kthread_t tid;
+	message_header *header;
+	char frame[NANVIX_MAILBOX_MESSAGE_SIZE];
+
+	TEST_ASSERT((inbox_frames.outbox = kmailbox_open(knode_get_num(), stdinbox_get_port())) >= 0);
+	TEST_ASSERT((tag = nanvix_inbox_tag()) > 0);
+
+	/*
+	 * Application payloads are untagged, whatever their bytes are.
+	 * Late responses to given up requests are discarded.
+	 */
+	header = (message_header *) inbox_frames.frames[1];
+	umemset(inbox_frames.frames[0], tag, NANVIX_MAILBOX_MESSAGE_SIZE);
+	message_header_build(header, 0);
+	header->tag = tag;
+	umemset(inbox_frames.frames[2], 1, NANVIX_MAILBOX_MESSAGE_SIZE);
+	inbox_frames.n = 3;
+
+	TEST_ASSERT(kthread_create(&tid, test_name_inbox_sender, NULL) == 0);
+	TEST_ASSERT(nanvix_inbox_read(NANVIX_INBOX_UNTAGGED, frame, NANVIX_MAILBOX_MESSAGE_SIZE) == NANVIX_MAILBOX_MESSAGE_SIZE);
+	TEST_ASSERT(umemcmp(frame, inbox_frames.frames[0], NANVIX_MAILBOX_MESSAGE_SIZE) == 0);
+	TEST_ASSERT(nanvix_inbox_untag(tag) == 0);
+	TEST_ASSERT(nanvix_inbox_read(NANVIX_INBOX_UNTAGGED, frame, NANVIX_MAILBOX_MESSAGE_SIZE) == NANVIX_MAILBOX_MESSAGE_SIZE);
+	TEST_ASSERT(umemcmp(frame, inbox_frames.frames[2], NANVIX_MAILBOX_MESSAGE_SIZE) == 0);
+	TEST_ASSERT(kthread_join(tid, NULL) == 0);
+
+	/* Messages are left in the mailbox when there is no room to park them. */
+	TEST_ASSERT((tag = nanvix_inbox_tag()) > 0);
+	for (int i = 0; i <= NANVIX_INBOX_PARKED_MAX; i++)
+		umemset(inbox_frames.frames[i], i + 1, NANVIX_MAILBOX_MESSAGE_SIZE);
+	inbox_frames.n = NANVIX_INBOX_PARKED_MAX + 1;
+
+	TEST_ASSERT(kthread_create(&tid, test_name_inbox_sender, NULL) == 0);
+	TEST_ASSERT(nanvix_inbox_read(tag, frame, NANVIX_MAILBOX_MESSAGE_SIZE) == -ENOBUFS);
+	for (int i = 0; i <= NANVIX_INBOX_PARKED_MAX; i++)
+	{
+		TEST_ASSERT(nanvix_inbox_read(NANVIX_INBOX_UNTAGGED, frame, NANVIX_MAILBOX_MESSAGE_SIZE) == NANVIX_MAILBOX_MESSAGE_SIZE);
+		TEST_ASSERT(frame[0] == (i + 1));
+	}
+	TEST_ASSERT(kthread_join(tid, NULL) == 0);
+
+	TEST_ASSERT(nanvix_inbox_untag(tag) == 0);
+	TEST_ASSERT(kmailbox_close(inbox_frames.outbox) == 0);
+}
+
 /*============================================================================*
  * API Test Driver Table                                                      *
  *============================================================================*/
@@ -95,8 +496,20 @@ static void test_name_heartbeat(void)
  * @brief Unit tests.
  */
 struct test tests_name_api[] = {
-	{ test_name_link_unlink, "link unlink"    },
-	{ test_name_lookup,      "lookup"         },
-	{ test_name_heartbeat,   "heartbeat"      },
-	{ NULL,                   NULL            }
+	{ test_name_link_unlink,   "link unlink"   },
+	{ test_name_lookup,        "lookup"        },
+	{ test_name_lookup_cached, "lookup cached" },
+	{ test_name_lookup_many,   "lookup many"   },
+	{ test_name_wait,          "wait"          },
+	{ test_name_wait_deferred, "wait deferred" },
+	{ test_name_heartbeat,     "heartbeat"     },
+	{ test_name_lookup_age,    "lookup age"    },
+#ifdef __NAME_ALIVE_TIMEOUT
+	{ test_name_eviction,      "eviction"      },
+#endif
+	{ test_name_stats,         "stats"         },
+	{ test_name_list,          "list"          },
+	{ test_name_inbox_tags,    "inbox tags"    },
+	{ test_name_inbox_demux,   "inbox demux"   },
+	{ NULL,                    NULL            }
 };
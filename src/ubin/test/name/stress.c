@@ -74,9 +74,44 @@ static void test_name_heartbeat(void)
 	for (int i = 0; i < NITERATIONS; i++)
 		TEST_ASSERT(name_heartbeat() == 0);
 
+	TEST_ASSERT(name_heartbeat_stop() == 0);
 	TEST_ASSERT(name_unlink(pathname) == 0);
 }
 
+/*============================================================================*
+ * Link Many                                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Link Many
+ */
+static void test_name_link_many(void)
+{
+	int nodenum;
+	char pathname[NANVIX_PROC_NAME_MAX];
+
+	nodenum = knode_get_num();
+
+	/* More names than NoC nodes. */
+	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	{
+		usprintf(pathname, "cool-name%d", i);
+		TEST_ASSERT(name_link(nodenum, pathname) == 0);
+	}
+
+	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	{
+		usprintf(pathname, "cool-name%d", i);
+		TEST_ASSERT(name_lookup(pathname) == nodenum);
+	}
+
+	for (int i = 0; i < NANVIX_PROC_MAX; i++)
+	{
+		usprintf(pathname, "cool-name%d", i);
+		TEST_ASSERT(name_unlink(pathname) == 0);
+	}
+}
+
 /*============================================================================*
  * Stress Tests Driver Table                                                  *
  *============================================================================*/
@@ -87,6 +122,7 @@ static void test_name_heartbeat(void)
 struct test tests_name_stress[] = {
 	{ test_name_lookup,    "lookup"    },
 	{ test_name_heartbeat, "heartbeat" },
+	{ test_name_link_many, "link many" },
 	{ NULL,                 NULL       },
 };
 
@@ -29,6 +29,11 @@
 /* Import definitions. */
 extern void *nanvix_malloc(size_t size);
 extern void nanvix_free(void *ptr);
+extern void *nanvix_realloc(void *ptr, size_t size);
+extern void *nanvix_calloc(size_t nmemb, size_t size);
+extern void *nanvix_memalign(size_t alignment, size_t size);
+extern void *nanvix_aligned_alloc(size_t alignment, size_t size);
+extern void nanvix_malloc_stats(size_t *retained, size_t *returned);
 
 /**
  * @brief Maximum value of unsigned char.
@@ -72,6 +77,200 @@ static void test_api_mem_read_write(void)
 	}
 }
 
+/*============================================================================*
+ * API Test: Small Objects                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Number of small objects.
+ */
+#define NUM_OBJECTS 32
+
+/**
+ * @brief API Test: Small Objects
+ */
+static void test_api_mem_small_objects(void)
+{
+	unsigned char *ptrs[NUM_OBJECTS];
+
+	for (unsigned k = 0; k < 2; k++)
+	{
+		/* Allocate objects of several size classes. */
+		for (unsigned i = 0; i < NUM_OBJECTS; i++)
+		{
+			unsigned size = 1 + ((i*37) % 2048);
+
+			TEST_ASSERT((ptrs[i] = nanvix_malloc(size)) != NULL);
+			ptrs[i][0] = i;
+			ptrs[i][size - 1] = i;
+		}
+
+		/* Objects must not overlap. */
+		for (unsigned i = 0; i < NUM_OBJECTS; i++)
+		{
+			unsigned size = 1 + ((i*37) % 2048);
+
+			TEST_ASSERT(ptrs[i][0] == i);
+			TEST_ASSERT(ptrs[i][size - 1] == i);
+		}
+
+		/* Free out of order. */
+		for (unsigned i = 1; i < NUM_OBJECTS; i += 2)
+			nanvix_free(ptrs[i]);
+		for (unsigned i = 0; i < NUM_OBJECTS; i += 2)
+			nanvix_free(ptrs[i]);
+	}
+}
+
+/*============================================================================*
+ * API Test: Trim                                                             *
+ *============================================================================*/
+
+/**
+ * @brief Number of pages in a large object.
+ */
+#define NUM_PAGES 32
+
+/**
+ * @brief API Test: Trim
+ */
+static void test_api_mem_trim(void)
+{
+	unsigned char *ptr;
+	size_t retained1, retained2;
+	size_t returned1, returned2;
+
+	TEST_ASSERT((ptr = nanvix_malloc(NUM_PAGES*PAGE_SIZE)) != NULL);
+
+	for (unsigned i = 0; i < NUM_PAGES; i++)
+		ptr[i*PAGE_SIZE] = UCHAR_MAX;
+
+	nanvix_malloc_stats(&retained1, &returned1);
+	nanvix_free(ptr);
+	nanvix_malloc_stats(&retained2, &returned2);
+
+	/* Whole pages of the freed object are given back. */
+	TEST_ASSERT(returned2 >= returned1 + (NUM_PAGES - 2)*PAGE_SIZE);
+	TEST_ASSERT(retained2 + (NUM_PAGES - 2)*PAGE_SIZE <= retained1);
+}
+
+/*============================================================================*
+ * API Test: Realloc                                                          *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Realloc
+ */
+static void test_api_mem_realloc(void)
+{
+	unsigned char *ptr;
+	unsigned char *newptr;
+
+	/* Small object. */
+	TEST_ASSERT((ptr = nanvix_malloc(64)) != NULL);
+	for (unsigned i = 0; i < 64; i++)
+		ptr[i] = i;
+	TEST_ASSERT((newptr = nanvix_realloc(ptr, 32)) == ptr);
+	TEST_ASSERT((ptr = nanvix_realloc(newptr, 3*PAGE_SIZE)) != NULL);
+	for (unsigned i = 0; i < 32; i++)
+		TEST_ASSERT(ptr[i] == i);
+	nanvix_free(ptr);
+
+	/* Large object. */
+	TEST_ASSERT((ptr = nanvix_malloc(4*PAGE_SIZE)) != NULL);
+	for (unsigned i = 0; i < 4*PAGE_SIZE; i++)
+		ptr[i] = i % (UCHAR_MAX + 1);
+	TEST_ASSERT((newptr = nanvix_realloc(ptr, 2*PAGE_SIZE)) == ptr);
+	TEST_ASSERT((ptr = nanvix_realloc(newptr, NUM_PAGES*PAGE_SIZE)) != NULL);
+	for (unsigned i = 0; i < 2*PAGE_SIZE; i++)
+		TEST_ASSERT(ptr[i] == i % (UCHAR_MAX + 1));
+	nanvix_free(ptr);
+}
+
+/*============================================================================*
+ * API Test: Realloc at the End of the Heap                                   *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Realloc at the End of the Heap
+ */
+static void test_api_mem_realloc_top(void)
+{
+	unsigned char *ptr;
+
+	/*
+	 * No free block fits this object, so it
+	 * lies at the end of a fresh heap expansion.
+	 */
+	TEST_ASSERT((ptr = nanvix_malloc(4*NUM_PAGES*PAGE_SIZE)) != NULL);
+	ptr[0] = UCHAR_MAX;
+
+	TEST_ASSERT(nanvix_realloc(ptr, 5*NUM_PAGES*PAGE_SIZE) == ptr);
+	TEST_ASSERT(ptr[0] == UCHAR_MAX);
+	ptr[5*NUM_PAGES*PAGE_SIZE - 1] = UCHAR_MAX;
+
+	nanvix_free(ptr);
+}
+
+/*============================================================================*
+ * API Test: Calloc                                                           *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Calloc
+ */
+static void test_api_mem_calloc(void)
+{
+	unsigned char *ptr;
+
+	/* Small object. */
+	TEST_ASSERT((ptr = nanvix_calloc(16, sizeof(unsigned char))) != NULL);
+	for (unsigned i = 0; i < 16; i++)
+		TEST_ASSERT(ptr[i] == 0);
+	nanvix_free(ptr);
+
+	/* Large object, dirtied and then allocated again. */
+	for (unsigned k = 0; k < 2; k++)
+	{
+		TEST_ASSERT((ptr = nanvix_calloc(NUM_PAGES, PAGE_SIZE)) != NULL);
+		for (unsigned i = 0; i < NUM_PAGES*PAGE_SIZE; i++)
+			TEST_ASSERT(ptr[i] == 0);
+		for (unsigned i = 0; i < NUM_PAGES*PAGE_SIZE; i++)
+			ptr[i] = UCHAR_MAX;
+		nanvix_free(ptr);
+	}
+}
+
+/*============================================================================*
+ * API Test: Aligned Alloc                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Aligned Alloc
+ */
+static void test_api_mem_aligned_alloc(void)
+{
+	unsigned char *ptr;
+
+	TEST_ASSERT((ptr = nanvix_memalign(64, 10)) != NULL);
+	TEST_ASSERT(((vaddr_t) ptr & (64 - 1)) == 0);
+	ptr[9] = UCHAR_MAX;
+	nanvix_free(ptr);
+
+	TEST_ASSERT((ptr = nanvix_memalign(PAGE_SIZE, 100)) != NULL);
+	TEST_ASSERT(((vaddr_t) ptr & (PAGE_SIZE - 1)) == 0);
+	ptr[99] = UCHAR_MAX;
+	nanvix_free(ptr);
+
+	TEST_ASSERT((ptr = nanvix_aligned_alloc(PAGE_SIZE, 3*PAGE_SIZE)) != NULL);
+	TEST_ASSERT(((vaddr_t) ptr & (PAGE_SIZE - 1)) == 0);
+	ptr[3*PAGE_SIZE - 1] = UCHAR_MAX;
+	nanvix_free(ptr);
+
+	TEST_ASSERT(nanvix_memalign(3, 10) == NULL);
+	TEST_ASSERT(nanvix_aligned_alloc(PAGE_SIZE, 10) == NULL);
+}
+
 /*============================================================================*
  * Stress Test: Read/Write                                                    *
  *============================================================================*/
@@ -102,8 +301,14 @@ static void test_stress_mem_read_write(void)
  * @brief Unit tests.
  */
 struct test tests_mem_api[] = {
-	{ test_api_mem_alloc_free,    "memory alloc/free" },
-	{ test_api_mem_read_write,    "memory read/write" },
-	{ test_stress_mem_read_write, "stress read/write" },
-	{ NULL,                       NULL                },
+	{ test_api_mem_alloc_free,    "memory alloc/free"    },
+	{ test_api_mem_read_write,    "memory read/write"    },
+	{ test_api_mem_small_objects, "memory small objects" },
+	{ test_api_mem_trim,          "memory trim"          },
+	{ test_api_mem_realloc,       "memory realloc"       },
+	{ test_api_mem_realloc_top,   "memory realloc top"   },
+	{ test_api_mem_calloc,        "memory calloc"        },
+	{ test_api_mem_aligned_alloc, "memory aligned alloc" },
+	{ test_stress_mem_read_write, "stress read/write"    },
+	{ NULL,                       NULL                   },
 };
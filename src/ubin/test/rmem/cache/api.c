@@ -26,6 +26,7 @@
 
 #include <nanvix/runtime/rmem.h>
 #include <nanvix/ulib.h>
+#include <posix/errno.h>
 #include "../../test.h"
 
 
@@ -88,6 +89,92 @@ static void test_rmem_rcache_put_write(void)
 	nanvix_rcache_clean();
 }
 
+/*============================================================================*
+ * API Test: Cache Install                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Cache Install
+ */
+static void test_rmem_rcache_install(void)
+{
+	rpage_t page;
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	TEST_ASSERT((page = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Overwrite page without fetching it. */
+	TEST_ASSERT((cache_data = nanvix_rcache_install(page)) != NULL);
+	umemset(cache_data, 2, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_put(page, 0) == 0);
+	TEST_ASSERT(nanvix_rcache_flush(page) == 0);
+
+	/* Drop cached copy and read it back. */
+	nanvix_rcache_clean();
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page)) != NULL);
+
+	/* Checksum */
+	for (size_t w = 0; w < RMEM_BLOCK_SIZE; w++)
+		TEST_ASSERT(cache_data[w] == 2);
+
+	TEST_ASSERT(nanvix_rcache_put(page, 0) == 0);
+	TEST_ASSERT(nanvix_rcache_free(page) == 0);
+	nanvix_rcache_clean();
+
+	/* Restore default policy. */
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_BYPASS);
+}
+
+/*============================================================================*
+ * API Test: Cache Bypass Read Write                                          *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Cache Bypass Read Write
+ */
+static void test_rmem_rcache_bypass_read_write(void)
+{
+	rpage_t page;
+	static char buffer[RMEM_BLOCK_SIZE];
+
+	TEST_ASSERT((page = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Direct transfers are only allowed in bypass mode. */
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+	TEST_ASSERT(nanvix_rcache_write(page, buffer, 1) == -ENOTSUP);
+	TEST_ASSERT(nanvix_rcache_read(page, buffer, 1) == -ENOTSUP);
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_BYPASS);
+
+	umemset(buffer, 3, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_write(page, buffer, 1) == 0);
+	umemset(buffer, 0, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_read(page, buffer, 1) == 0);
+
+	/* Checksum */
+	for (size_t w = 0; w < RMEM_BLOCK_SIZE; w++)
+		TEST_ASSERT(buffer[w] == 3);
+
+	/* Direct reads see cached updates. */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page)) != NULL);
+	umemset(cache_data, 4, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_read(page, buffer, 1) == 0);
+	for (size_t w = 0; w < RMEM_BLOCK_SIZE; w++)
+		TEST_ASSERT(buffer[w] == 4);
+
+	/* Direct writes drop stale cached copies. */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page)) != NULL);
+	umemset(buffer, 5, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_write(page, buffer, 1) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page)) != NULL);
+	for (size_t w = 0; w < RMEM_BLOCK_SIZE; w++)
+		TEST_ASSERT(cache_data[w] == 5);
+
+	TEST_ASSERT(nanvix_rcache_free(page) == 0);
+	nanvix_rcache_clean();
+}
+
 /*============================================================================*
  * API Test: Cache Get Flush                                                  *
  *============================================================================*/
@@ -314,6 +401,53 @@ static void test_rmem_rcache_aging(void)
 
 	nanvix_rcache_clean();
 }
+
+/*============================================================================*
+ * API Test: Cache Pin Unpin                                                  *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Cache Pin Unpin
+ */
+static void test_rmem_rcache_pin_unpin(void)
+{
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	/* Allocate every page available plus one for evict purposes. */
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Get every page to put it in the cache. */
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+	}
+
+	/* Pin the oldest page. */
+	TEST_ASSERT(nanvix_rcache_pin(page_num[0*RMEM_CACHE_BLOCK_SIZE]) == 0);
+
+	/* Eviction will occur */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+
+	/* Check if the pinned page was skipped. */
+	TEST_ASSERT(nanvix_rcache_flush(page_num[0*RMEM_CACHE_BLOCK_SIZE]) == 0);
+	TEST_ASSERT(nanvix_rcache_flush(page_num[1*RMEM_CACHE_BLOCK_SIZE]) < 0);
+
+	/* Unpin page. */
+	TEST_ASSERT(nanvix_rcache_unpin(page_num[0*RMEM_CACHE_BLOCK_SIZE]) == 0);
+	TEST_ASSERT(nanvix_rcache_unpin(page_num[0*RMEM_CACHE_BLOCK_SIZE]) < 0);
+
+	/* Free every used page. */
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+
+	nanvix_rcache_clean();
+
+	/* Restore default policy. */
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_BYPASS);
+}
+
 /*============================================================================*
  * Test Driver Table                                                          *
  *============================================================================*/
@@ -322,12 +456,15 @@ static void test_rmem_rcache_aging(void)
  * @brief Unit tests.
  */
 struct test tests_rmem_cache_api[] = {
-	{ NULL,                         NULL        },
-	{ test_rmem_rcache_alloc_free, "alloc free" },
-	{ test_rmem_rcache_put_write,  "put write"  },
-	{ test_rmem_rcache_get_flush,  "get flush"  },
-	{ test_rmem_rcache_fifo,       "fifo"       },
-	{ test_rmem_rcache_lifo,       "lifo"       },
-	{ test_rmem_rcache_nfu,        "nfu"        },
-	{ test_rmem_rcache_aging,      "aging"      },
+	{ test_rmem_rcache_pin_unpin,         "pin unpin"         },
+	{ test_rmem_rcache_install,           "install"           },
+	{ test_rmem_rcache_bypass_read_write, "bypass read write" },
+	{ NULL,                               NULL                },
+	{ test_rmem_rcache_alloc_free,        "alloc free"        },
+	{ test_rmem_rcache_put_write,         "put write"         },
+	{ test_rmem_rcache_get_flush,         "get flush"         },
+	{ test_rmem_rcache_fifo,              "fifo"              },
+	{ test_rmem_rcache_lifo,              "lifo"              },
+	{ test_rmem_rcache_nfu,               "nfu"               },
+	{ test_rmem_rcache_aging,             "aging"             },
 };
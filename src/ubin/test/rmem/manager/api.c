@@ -22,7 +22,10 @@
 
 #define __NEED_MM_MANAGER
 
+#define __NEED_RMEM_CACHE
+
 #include <nanvix/runtime/rmem.h>
+#include <nanvix/sys/thread.h>
 #include <nanvix/ulib.h>
 #include "../../test.h"
 
@@ -33,6 +36,16 @@
  */
 static char buffer[RMEM_BLOCK_SIZE];
 
+/**
+ * @brief Number of pages used in multi-page tests.
+ */
+#define NUM_PAGES 4
+
+/**
+ * @brief Dummy buffer used for multi-page tests.
+ */
+static char buffers[NUM_PAGES*RMEM_BLOCK_SIZE];
+
 /*============================================================================*
  * API Test: Alloc/Free                                                       *
  *============================================================================*/
@@ -97,13 +110,338 @@ static void test_rmem_manager_read_write(void)
 	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
 }
 
+/*============================================================================*
+ * API Test: Read/Write Multi-Page                                            *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Read/Write Multi-Page
+ */
+static void test_rmem_manager_read_write_multipage(void)
+{
+	char *ptr;
+	size_t base = RMEM_BLOCK_SIZE/2;
+	size_t n = (NUM_PAGES - 1)*RMEM_BLOCK_SIZE;
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+
+	/* Unaligned write that spans pages. */
+	for (size_t i = 0; i < n; i++)
+		buffers[i] = (char)(i/RMEM_BLOCK_SIZE + 1);
+	TEST_ASSERT(nanvix_vmem_write(&ptr[base], buffers, n) == n);
+
+	/* Unaligned read that spans pages. */
+	umemset(buffers, 0, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_read(buffers, &ptr[base], n) == n);
+
+	/* Checksum. */
+	for (size_t i = 0; i < n; i++)
+		TEST_ASSERT(buffers[i] == (char)(i/RMEM_BLOCK_SIZE + 1));
+
+	/* Past the end of the region. */
+	TEST_ASSERT(nanvix_vmem_read(buffers, &ptr[base], NUM_PAGES*RMEM_BLOCK_SIZE) == 0);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
+/*============================================================================*
+ * API Test: Write Install                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Write Install
+ */
+static void test_rmem_manager_write_install(void)
+{
+	char *ptr;
+	char *ptr2;
+
+	/* Full-page writes go through the cache only when it is enabled. */
+	TEST_ASSERT(nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO) == 0);
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+
+	/* Full-page writes, installed without fetching. */
+	umemset(buffers, 1, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(ptr, buffers, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+
+	/* Partial write, which fetches the page. */
+	umemset(buffer, 2, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(&ptr[RMEM_BLOCK_SIZE/2], buffer, RMEM_BLOCK_SIZE/2) == RMEM_BLOCK_SIZE/2);
+
+	/* Push the pages above out of the cache. */
+	TEST_ASSERT((ptr2 = nanvix_vmem_alloc(RMEM_CACHE_SIZE)) != NULL);
+	umemset(buffer, 3, RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < RMEM_CACHE_SIZE; i++)
+		TEST_ASSERT(nanvix_vmem_write(&ptr2[i*RMEM_BLOCK_SIZE], buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+
+	/* Checksum. */
+	umemset(buffers, 0, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_read(buffers, ptr, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE/2; i++)
+		TEST_ASSERT(buffers[i] == 1);
+	for (size_t i = RMEM_BLOCK_SIZE/2; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 2);
+	for (size_t i = RMEM_BLOCK_SIZE; i < NUM_PAGES*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 1);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr2) == 0);
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+
+	/* Restore default policy. */
+	TEST_ASSERT(nanvix_rcache_select_replacement_policy(RMEM_CACHE_BYPASS) == 0);
+}
+
+/*============================================================================*
+ * API Test: Concurrent Faults                                                *
+ *============================================================================*/
+
+/**
+ * @brief Number of threads used in concurrent fault tests.
+ */
+#define NUM_FAULTERS 2
+
+/**
+ * @brief Faults raised in concurrent fault tests.
+ */
+static struct
+{
+	volatile char *page; /**< Faulting page. */
+	char value;          /**< Value read.    */
+} faults[NUM_FAULTERS];
+
+/**
+ * @brief Reads a remote page, so that it faults.
+ *
+ * @param args Target fault.
+ *
+ * @returns Always returns NULL.
+ */
+static void *test_rmem_manager_fault(void *args)
+{
+	int i = (int)(long) args;
+
+	faults[i].value = faults[i].page[0];
+
+	return (NULL);
+}
+
+/**
+ * @brief API Test: Concurrent Faults
+ */
+static void test_rmem_manager_concurrent_faults(void)
+{
+	char *ptr;
+	char *ptr2;
+	kthread_t tids[NUM_FAULTERS];
+
+	/* Faults claim cache lines only when the cache is enabled. */
+	TEST_ASSERT(nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO) == 0);
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_FAULTERS)) != NULL);
+
+	for (int i = 0; i < NUM_FAULTERS; i++)
+	{
+		umemset(buffer, i + 1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_write(&ptr[i*RMEM_BLOCK_SIZE], buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+	}
+
+	/* Push the pages above out of the cache, so that faults fetch them. */
+	TEST_ASSERT((ptr2 = nanvix_vmem_alloc(RMEM_CACHE_SIZE)) != NULL);
+	umemset(buffer, 0, RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < RMEM_CACHE_SIZE; i++)
+		TEST_ASSERT(nanvix_vmem_write(&ptr2[i*RMEM_BLOCK_SIZE], buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+
+	/* Fault on different pages at once, so that fetches overlap. */
+	for (int i = 0; i < NUM_FAULTERS; i++)
+	{
+		faults[i].page = &ptr[i*RMEM_BLOCK_SIZE];
+		faults[i].value = 0;
+	}
+	for (int i = 0; i < NUM_FAULTERS; i++)
+		TEST_ASSERT(kthread_create(&tids[i], test_rmem_manager_fault, (void *)(long) i) == 0);
+	for (int i = 0; i < NUM_FAULTERS; i++)
+		TEST_ASSERT(kthread_join(tids[i], NULL) == 0);
+
+	/* Checksum. */
+	for (int i = 0; i < NUM_FAULTERS; i++)
+		TEST_ASSERT(faults[i].value == (i + 1));
+
+	TEST_ASSERT(nanvix_vmem_free(ptr2) == 0);
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+
+	/* Restore default policy. */
+	TEST_ASSERT(nanvix_rcache_select_replacement_policy(RMEM_CACHE_BYPASS) == 0);
+}
+
+/*============================================================================*
+ * API Test: Readv/Writev                                                     *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Readv/Writev
+ */
+static void test_rmem_manager_readv_writev(void)
+{
+	char *ptr;
+	struct rmem_iovec iov[2];
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+
+	/* Gather two buffers. */
+	umemset(buffer, 1, RMEM_BLOCK_SIZE);
+	umemset(buffers, 2, NUM_PAGES*RMEM_BLOCK_SIZE);
+	iov[0].iov_base = buffer;
+	iov[0].iov_len = RMEM_BLOCK_SIZE/2;
+	iov[1].iov_base = buffers;
+	iov[1].iov_len = 2*RMEM_BLOCK_SIZE;
+	TEST_ASSERT(nanvix_vmem_writev(ptr, iov, 2) == (RMEM_BLOCK_SIZE/2 + 2*RMEM_BLOCK_SIZE));
+
+	/* Scatter them back. */
+	umemset(buffer, 0, RMEM_BLOCK_SIZE);
+	umemset(buffers, 0, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_readv(ptr, iov, 2) == (RMEM_BLOCK_SIZE/2 + 2*RMEM_BLOCK_SIZE));
+
+	/* Checksum. */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE/2; i++)
+		TEST_ASSERT(buffer[i] == 1);
+	for (size_t i = 0; i < 2*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 2);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
+/*============================================================================*
+ * API Test: Reserve                                                          *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Reserve
+ */
+static void test_rmem_manager_reserve(void)
+{
+	char *ptr;
+
+	TEST_ASSERT((ptr = nanvix_vmem_reserve(NUM_PAGES)) != NULL);
+
+	/* Untouched pages read as zeros. */
+	umemset(buffers, 1, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_read(buffers, ptr, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < NUM_PAGES*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 0);
+
+	/* Touch last page. */
+	umemset(buffer, 2, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(&ptr[(NUM_PAGES - 1)*RMEM_BLOCK_SIZE], buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+
+	/* Checksum. */
+	TEST_ASSERT(nanvix_vmem_read(buffers, ptr, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < (NUM_PAGES - 1)*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 0);
+	for (size_t i = (NUM_PAGES - 1)*RMEM_BLOCK_SIZE; i < NUM_PAGES*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 2);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
+/*============================================================================*
+ * API Test: Advise                                                           *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Advise
+ */
+static void test_rmem_manager_advise(void)
+{
+	char *ptr;
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+
+	/* Streaming accesses. */
+	TEST_ASSERT(nanvix_vmem_advise(ptr, NUM_PAGES*RMEM_BLOCK_SIZE, RMEM_ADVICE_NOREUSE) == 0);
+	umemset(buffers, 1, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(ptr, buffers, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	umemset(buffers, 0, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_read(buffers, ptr, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < NUM_PAGES*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 1);
+
+	/* Prefetch. */
+	TEST_ASSERT(nanvix_vmem_advise(ptr, NUM_PAGES*RMEM_BLOCK_SIZE, RMEM_ADVICE_WILLNEED) == 0);
+
+#if (RMEM_CACHE_BLOCK_SIZE <= NUM_PAGES)
+
+	/* Dropped pages read as zeros. */
+	TEST_ASSERT(nanvix_vmem_advise(ptr, NUM_PAGES*RMEM_BLOCK_SIZE, RMEM_ADVICE_DONTNEED) == 0);
+	TEST_ASSERT(nanvix_vmem_read(buffers, ptr, NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < NUM_PAGES*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffers[i] == 0);
+
+#endif
+
+	/* Bad advices. */
+	TEST_ASSERT(nanvix_vmem_advise(ptr, RMEM_BLOCK_SIZE, -1) < 0);
+	TEST_ASSERT(nanvix_vmem_advise(&ptr[1], RMEM_BLOCK_SIZE, RMEM_ADVICE_NORMAL) < 0);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
+/*============================================================================*
+ * API Test: Free Out of Order                                                *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Free Out of Order
+ */
+static void test_rmem_manager_free_out_of_order(void)
+{
+	char *ptr1;
+	char *ptr2;
+	char *ptr3;
+	char *ptr4;
+
+	TEST_ASSERT((ptr1 = nanvix_vmem_alloc(1)) != NULL);
+	TEST_ASSERT((ptr2 = nanvix_vmem_alloc(1)) != NULL);
+	TEST_ASSERT((ptr3 = nanvix_vmem_alloc(1)) != NULL);
+
+	umemset(buffer, 1, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(ptr1, buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+	umemset(buffer, 3, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(ptr3, buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+
+	/* Release middle region. */
+	TEST_ASSERT(nanvix_vmem_free(ptr2) == 0);
+
+	/* Neighbours must be untouched. */
+	TEST_ASSERT(nanvix_vmem_read(buffer, ptr1, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffer[i] == 1);
+	TEST_ASSERT(nanvix_vmem_read(buffer, ptr3, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffer[i] == 3);
+
+	/* Hole should be reused. */
+	TEST_ASSERT((ptr4 = nanvix_vmem_alloc(1)) == ptr2);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr1) == 0);
+	TEST_ASSERT(nanvix_vmem_free(ptr4) == 0);
+	TEST_ASSERT(nanvix_vmem_free(ptr3) == 0);
+}
+
 /*============================================================================*/
 
 /**
  * @brief Unit tests.
  */
 struct test tests_rmem_manager_api[] = {
-	{ test_rmem_manager_alloc_free, "alloc/free"      },
-	{ test_rmem_manager_read_write, "read/write"      },
-	{ NULL,                            NULL             },
+	{ test_rmem_manager_alloc_free,           "alloc/free"            },
+	{ test_rmem_manager_read_write,           "read/write"            },
+	{ test_rmem_manager_read_write_multipage, "read/write multi-page" },
+	{ test_rmem_manager_write_install,        "write install"         },
+	{ test_rmem_manager_concurrent_faults,    "concurrent faults"     },
+	{ test_rmem_manager_readv_writev,         "readv/writev"          },
+	{ test_rmem_manager_reserve,              "reserve"               },
+	{ test_rmem_manager_advise,               "advise"                },
+	{ test_rmem_manager_free_out_of_order,    "free out of order"     },
+	{ NULL,                                   NULL                    },
 };
@@ -31,7 +31,7 @@
 /**
  * @brief Dummy buffer.
  */
-static char buffer[RMEM_BLOCK_SIZE];
+static char buffer[RMEM_RUN_MAX*RMEM_BLOCK_SIZE];
 
 /*============================================================================*
  * API Test: Alloc/Free                                                       *
@@ -122,6 +122,41 @@ static void test_rmem_stub_consistency(void)
 	TEST_ASSERT(nanvix_rmem_free(blknum3) == 0);
 }
 
+/*============================================================================*
+ * API Test: Run Read Write                                                   *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Run Read Write
+ */
+static void test_rmem_stub_run_read_write(void)
+{
+	rpage_t blknum;
+
+	TEST_ASSERT((blknum = nanvix_rmem_nalloc(RMEM_RUN_MAX)) != RMEM_NULL);
+	TEST_ASSERT((blknum % RMEM_RUN_MAX) == 0);
+
+		for (int i = 0; i < RMEM_RUN_MAX; i++)
+			umemset(&buffer[i*RMEM_BLOCK_SIZE], i + 1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rmem_nwrite(blknum, buffer, RMEM_RUN_MAX) == RMEM_RUN_MAX*RMEM_BLOCK_SIZE);
+
+		/* Checksum. */
+		umemset(buffer, 0, RMEM_RUN_MAX*RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rmem_nread(blknum, buffer, RMEM_RUN_MAX) == RMEM_RUN_MAX*RMEM_BLOCK_SIZE);
+		for (unsigned long i = 0; i < RMEM_RUN_MAX*RMEM_BLOCK_SIZE; i++)
+			TEST_ASSERT(buffer[i] == (char)(i/RMEM_BLOCK_SIZE + 1));
+
+		/* Single blocks of the run. */
+		for (int i = 0; i < RMEM_RUN_MAX; i++)
+		{
+			TEST_ASSERT(nanvix_rmem_read(blknum + i, buffer) == RMEM_BLOCK_SIZE);
+			TEST_ASSERT(buffer[0] == (char)(i + 1));
+		}
+
+	for (int i = 0; i < RMEM_RUN_MAX; i++)
+		TEST_ASSERT(nanvix_rmem_free(blknum + i) == 0);
+}
+
 /*============================================================================*
  * Test Driver Table                                                          *
  *============================================================================*/
@@ -130,8 +165,9 @@ static void test_rmem_stub_consistency(void)
  * @brief Unit tests.
  */
 struct test tests_rmem_stub_api[] = {
-	{ test_rmem_stub_alloc_free, "alloc/free"   },
-	{ test_rmem_stub_read_write, "read/write"   },
-	{ test_rmem_stub_consistency, "consistency" },
-	{ NULL,                       NULL          },
+	{ test_rmem_stub_alloc_free,     "alloc/free"     },
+	{ test_rmem_stub_read_write,     "read/write"     },
+	{ test_rmem_stub_consistency,    "consistency"    },
+	{ test_rmem_stub_run_read_write, "run read/write" },
+	{ NULL,                          NULL             },
 };
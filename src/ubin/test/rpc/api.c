@@ -0,0 +1,221 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2011-2018 Pedro Henrique Penna <pedrohenriquepenna@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.  THE SOFTWARE IS PROVIDED
+ * "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <nanvix/runtime/rpc.h>
+#include <nanvix/runtime/stdikc.h>
+#include <nanvix/servers/message.h>
+#include <nanvix/sys/mailbox.h>
+#include <nanvix/sys/noc.h>
+#include <nanvix/sys/semaphore.h>
+#include <nanvix/sys/thread.h>
+#include <nanvix/ulib.h>
+#include "../test.h"
+
+/**
+ * @name Operations of the test server.
+ */
+/**@{*/
+#define RPC_TEST_INC  1 /**< Increment a value. */
+#define RPC_TEST_EXIT 2 /**< Shut down.         */
+/**@}*/
+
+/**
+ * @brief Number of calls in a test.
+ */
+#define NUM_CALLS 16
+
+/**
+ * @brief Number of dispatch threads in multi-threaded tests.
+ */
+#define NUM_THREADS 3
+
+/**
+ * @brief Test message.
+ */
+struct rpc_test_message
+{
+	message_header header; /**< Message header. */
+	int value;             /**< Value.          */
+};
+
+/**
+ * @brief Test server.
+ */
+static struct
+{
+	int nthreads;                  /**< Dispatch threads.     */
+	int flags;                     /**< Server flags.         */
+	struct nanvix_semaphore ready; /**< Server is listening?  */
+	struct nanvix_rpc_server rpc;  /**< RPC server.           */
+} server;
+
+/**
+ * @brief Handles an increment request.
+ */
+static int test_rpc_inc(struct nanvix_rpc_server *rpc, const void *request, void *response)
+{
+	((void) rpc);
+
+	((struct rpc_test_message *) response)->value =
+		((const struct rpc_test_message *) request)->value + 1;
+
+	return (NANVIX_RPC_REPLY);
+}
+
+/**
+ * @brief Handles a shutdown request.
+ */
+static int test_rpc_exit(struct nanvix_rpc_server *rpc, const void *request, void *response)
+{
+	((void) rpc);
+	((void) request);
+	((void) response);
+
+	return (NANVIX_RPC_SHUTDOWN);
+}
+
+/**
+ * @brief Runs the test server.
+ *
+ * The server listens to the standard input mailbox of its own thread,
+ * so that it does not steal responses of the main one.
+ */
+static void *test_rpc_server(void *args)
+{
+	((void) args);
+
+	uassert(__stdmailbox_setup() == 0);
+
+	uassert(
+		nanvix_rpc_server_init(
+			&server.rpc,
+			stdinbox_get(),
+			stdinbox_get_port(),
+			sizeof(struct rpc_test_message),
+			server.flags
+		) == 0
+	);
+	uassert(nanvix_rpc_register(&server.rpc, RPC_TEST_INC, test_rpc_inc) == 0);
+	uassert(nanvix_rpc_register(&server.rpc, RPC_TEST_EXIT, test_rpc_exit) == 0);
+
+	nanvix_semaphore_up(&server.ready);
+
+	uassert(nanvix_rpc_loop(&server.rpc, server.nthreads) == 0);
+	uassert(nanvix_rpc_server_cleanup(&server.rpc) == 0);
+
+	uassert(__stdmailbox_cleanup() == 0);
+
+	return (NULL);
+}
+
+/**
+ * @brief Issues calls to a test server, and then shuts it down.
+ *
+ * @param nthreads Number of dispatch threads.
+ * @param flags    Server flags.
+ */
+static void test_rpc_run(int nthreads, int flags)
+{
+	int outbox;
+	kthread_t tid;
+	struct rpc_test_message msg;
+
+	server.nthreads = nthreads;
+	server.flags = flags;
+	nanvix_semaphore_init(&server.ready, 0);
+
+	TEST_ASSERT(kthread_create(&tid, test_rpc_server, NULL) == 0);
+	nanvix_semaphore_down(&server.ready);
+
+	TEST_ASSERT((outbox = kmailbox_open(knode_get_num(), server.rpc.port)) >= 0);
+
+	for (int i = 0; i < NUM_CALLS; i++)
+	{
+		message_header_build(&msg.header, RPC_TEST_INC);
+		msg.value = i;
+		TEST_ASSERT(nanvix_rpc_call(outbox, &msg, sizeof(msg)) == 0);
+		TEST_ASSERT(msg.value == i + 1);
+	}
+
+	/* Shutdowns are not answered. */
+	message_header_build(&msg.header, RPC_TEST_EXIT);
+	TEST_ASSERT(kmailbox_write(outbox, &msg, sizeof(msg)) == (ssize_t) sizeof(msg));
+
+	/* All dispatch threads are woken up. */
+	TEST_ASSERT(kthread_join(tid, NULL) == 0);
+	TEST_ASSERT(kmailbox_close(outbox) == 0);
+
+	TEST_ASSERT(server.rpc.stats[RPC_TEST_INC].count == NUM_CALLS);
+	TEST_ASSERT(server.rpc.stats[RPC_TEST_EXIT].count == 1);
+}
+
+/*============================================================================*
+ * API Test: Dispatch                                                         *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Dispatch
+ */
+static void test_rpc_dispatch(void)
+{
+	test_rpc_run(1, 0);
+}
+
+/*============================================================================*
+ * API Test: Dispatch Threads                                                 *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Dispatch Threads
+ */
+static void test_rpc_dispatch_threads(void)
+{
+	test_rpc_run(NUM_THREADS, 0);
+}
+
+/*============================================================================*
+ * API Test: Dispatch Concurrent                                              *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Dispatch Concurrent
+ */
+static void test_rpc_dispatch_concurrent(void)
+{
+	test_rpc_run(NUM_THREADS, NANVIX_RPC_CONCURRENT);
+}
+
+/*============================================================================*
+ * API Test Driver Table                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Unit tests.
+ */
+struct test tests_rpc_api[] = {
+	{ test_rpc_dispatch,            "dispatch"            },
+	{ test_rpc_dispatch_threads,    "dispatch threads"    },
+	{ test_rpc_dispatch_concurrent, "dispatch concurrent" },
+	{ NULL,                         NULL                  }
+};
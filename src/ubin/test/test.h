@@ -46,6 +46,16 @@
 	 */
 	extern void test_name(void);
 
+	/**
+	 * @brief Launches regression tests on mailboxes.
+	 */
+	extern void test_mailbox(void);
+
+	/**
+	 * @brief Launches regression tests on RPC dispatch.
+	 */
+	extern void test_rpc(void);
+
 	/**
 	 * @brief Launches regression tests on RMem Manager.
 	 */